@@ -0,0 +1,202 @@
+/**
+ * @file bench.hpp
+ * @brief Benchmark harness header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Helpers shared by the benchmarks: pty pairs as stand-in devices, helper
+ * threads for the master side, percentiles of latency samples and results as
+ * JSON lines, one object per measurement, to compare runs between releases.
+ * With the environment variable BENCH_SHORT, as set by bench-check, the
+ * benchmarks run a fraction of their iterations and only check the results.
+ */
+
+
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdlib>
+
+#include <pty.h>
+#include <unistd.h>
+#include <poll.h>
+
+
+#define BENCH_SHORT_DIVISOR                     100                                 // iterations and durations divided in short runs
+
+
+namespace bench
+{
+    // pty pair, the slave is opened by Serial, the master side plays the device
+    class PtyPair
+    {
+    public:
+        int master_fd;
+        int slave_fd;
+        std::string name;
+        
+        PtyPair(void)
+        {
+            char buffer[64];
+            
+            if(openpty(&this->master_fd, &this->slave_fd, buffer, NULL, NULL) != 0)
+                throw std::runtime_error("openpty failed");
+            
+            this->name = buffer;
+        }
+        
+        PtyPair(const PtyPair&) = delete;
+        
+        ~PtyPair(void)
+        {
+            ::close(this->slave_fd);
+            ::close(this->master_fd);
+        }
+    };
+    
+    
+    // thread on the master side, which loops back, drains or feeds data until it is stopped
+    class Peer
+    {
+    private:
+        std::thread thread;
+        std::atomic<bool> stop_flag;
+    public:
+        enum class Mode
+        {
+            LOOPBACK,                                   // send received data back
+            DRAIN,
+            FEED
+        };
+        
+        Peer(int master_fd, Mode mode) : Peer(master_fd, mode, std::vector<uint8_t>()) {}
+        
+        Peer(int master_fd, Mode mode, std::vector<uint8_t> pattern) : stop_flag(false)     // FEED writes the pattern repeatedly
+        {
+            this->thread = std::thread([this, master_fd, mode, pattern]() {
+                uint8_t buffer[65536];
+                struct pollfd poll_fd = {master_fd, (short)((mode == Mode::FEED) ? POLLOUT : POLLIN), 0};
+                size_t offset = 0;
+                
+                while(this->stop_flag == false)
+                {
+                    if(poll(&poll_fd, 1, 50) <= 0)
+                        continue;
+                    
+                    if(mode == Mode::FEED)
+                    {
+                        ssize_t num = ::write(master_fd, pattern.data() + offset, pattern.size() - offset);
+                        
+                        if(num > 0)
+                            offset = (offset + num) % pattern.size();
+                        continue;
+                    }
+                    
+                    ssize_t num = ::read(master_fd, buffer, sizeof(buffer));
+                    
+                    if(num <= 0)
+                        break;
+                    if(mode == Mode::LOOPBACK && ::write(master_fd, buffer, num) != num)
+                        break;
+                }
+            });
+        }
+        
+        Peer(const Peer&) = delete;
+        
+        ~Peer(void)
+        {
+            this->stop_flag = true;
+            this->thread.join();
+        }
+    };
+    
+    
+    // iterations of a measurement, shortened if BENCH_SHORT is set
+    inline size_t iterations(size_t count)
+    {
+        if(std::getenv("BENCH_SHORT") == NULL)
+            return count;
+        
+        return std::max<size_t>(count / BENCH_SHORT_DIVISOR, 1);
+    }
+    
+    
+    // duration of a measurement in seconds, shortened if BENCH_SHORT is set
+    inline double duration(double seconds)
+    {
+        return (std::getenv("BENCH_SHORT") == NULL) ? seconds : seconds / BENCH_SHORT_DIVISOR;
+    }
+    
+    
+    // p in [0, 1], samples are sorted in place
+    inline double percentile(std::vector<double>& samples, double p)
+    {
+        if(samples.empty() == true)
+            return 0.0;
+        
+        std::sort(samples.begin(), samples.end());
+        
+        return samples[std::min(samples.size() - 1, (size_t)(p * samples.size()))];
+    }
+    
+    
+    // one JSON object per line, e.g. {"bench":"read","payload":64,"mb_per_s":12.5}
+    class Record
+    {
+    private:
+        std::ostringstream stream;
+        bool first_flag;
+        
+        void key(const std::string& name)
+        {
+            this->stream << (this->first_flag ? "{" : ",") << "\"" << name << "\":";
+            this->first_flag = false;
+        }
+    public:
+        explicit Record(const std::string& bench) : first_flag(true)
+        {
+            this->add("bench", bench);
+        }
+        
+        Record& add(const std::string& name, const std::string& value)
+        {
+            this->key(name);
+            this->stream << "\"" << value << "\"";
+            return *this;
+        }
+        
+        Record& add(const std::string& name, const char* value)
+        {
+            return this->add(name, std::string(value));
+        }
+        
+        Record& add(const std::string& name, double value)
+        {
+            this->key(name);
+            this->stream << value;
+            return *this;
+        }
+        
+        void print(void)
+        {
+            std::cout << this->stream.str() << "}" << std::endl;
+        }
+    };
+}
+
+
+#endif
+
+
+
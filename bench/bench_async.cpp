@@ -0,0 +1,185 @@
+/**
+ * @file bench_async.cpp
+ * @brief Async request/response benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Sends requests on N pty pairs and waits for the echoed response, once with
+ * one blocking thread per port and once with coroutines on one event loop.
+ * The device side of all ports is served by one epoll thread.
+ */
+
+
+#include "serial.hpp"
+#include "event_loop.hpp"
+#include "bench.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+
+
+#define BENCH_REQUESTS_PER_PORT                 500
+#define BENCH_REQUEST                           "request 0123456789abcdef\n"
+
+
+// device side of all ports, echoes every request
+class EchoDevices
+{
+private:
+    std::thread thread;
+    std::atomic<bool> stop_flag;
+public:
+    explicit EchoDevices(std::vector<std::unique_ptr<bench::PtyPair>>& ptys) : stop_flag(false)
+    {
+        int epoll_fd = epoll_create1(0);
+        
+        for(size_t i = 0; i < ptys.size(); i++)
+        {
+            struct epoll_event event;
+            event.events = EPOLLIN;
+            event.data.fd = ptys[i]->master_fd;
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, ptys[i]->master_fd, &event);
+        }
+        
+        this->thread = std::thread([this, epoll_fd]() {
+            struct epoll_event events[64];
+            uint8_t buffer[4096];
+            
+            while(this->stop_flag == false)
+            {
+                int num = epoll_wait(epoll_fd, events, 64, 50);
+                
+                for(int i = 0; i < num; i++)
+                {
+                    ssize_t size = ::read(events[i].data.fd, buffer, sizeof(buffer));
+                    
+                    if(size > 0 && ::write(events[i].data.fd, buffer, size) != size)
+                        throw std::runtime_error("write failed");
+                }
+            }
+            
+            ::close(epoll_fd);
+        });
+    }
+    
+    ~EchoDevices(void)
+    {
+        this->stop_flag = true;
+        this->thread.join();
+    }
+};
+
+
+static long context_switches(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+
+static void report(const char* mode, size_t ports, std::chrono::steady_clock::time_point start, long switches)
+{
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double requests = (double)ports * BENCH_REQUESTS_PER_PORT;
+    
+    bench::Record("request_response").add("mode", mode).add("ports", (double)ports)
+        .add("requests_per_s", requests / elapsed.count()).add("ctx_switches", (double)(context_switches() - switches)).print();
+}
+
+
+static void bench_threads(std::vector<std::unique_ptr<serial::Serial>>& ports)
+{
+    std::vector<std::thread> clients;
+    long switches = context_switches();
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < ports.size(); i++)
+    {
+        serial::Serial* port = ports[i].get();
+        clients.push_back(std::thread([port]() {
+            for(int request = 0; request < BENCH_REQUESTS_PER_PORT; request++)
+            {
+                port->write(BENCH_REQUEST);
+                port->readline();
+            }
+        }));
+    }
+    
+    for(size_t i = 0; i < clients.size(); i++)
+        clients[i].join();
+    
+    report("thread per port", ports.size(), start, switches);
+}
+
+
+static serial::Task<void> client(serial::Serial& port, serial::EventLoop& loop)
+{
+    for(int request = 0; request < BENCH_REQUESTS_PER_PORT; request++)
+    {
+        co_await port.async_write(loop, BENCH_REQUEST);
+        co_await port.async_readline(loop);
+    }
+}
+
+
+static void bench_coroutines(std::vector<std::unique_ptr<serial::Serial>>& ports)
+{
+    serial::EventLoop loop;
+    long switches = context_switches();
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < ports.size(); i++)
+        loop.spawn(client(*ports[i], loop));
+    
+    loop.run();
+    
+    report("coroutines", ports.size(), start, switches);
+}
+
+
+int main(void)
+{
+    const size_t port_counts[] = {1, 16, 64, 256};
+    
+    try
+    {
+        for(size_t num : port_counts)
+        {
+            std::vector<std::unique_ptr<bench::PtyPair>> ptys;
+            std::vector<std::unique_ptr<serial::Serial>> ports;
+            
+            for(size_t i = 0; i < num; i++)
+            {
+                ptys.push_back(std::make_unique<bench::PtyPair>());
+                ports.push_back(std::make_unique<serial::Serial>(ptys[i]->name, 115200, 5.0));
+                ports[i]->open();
+            }
+            
+            EchoDevices devices(ptys);
+            
+            bench_threads(ports);
+            bench_coroutines(ports);
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+
+
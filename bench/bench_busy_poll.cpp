@@ -0,0 +1,88 @@
+/**
+ * @file bench_busy_poll.cpp
+ * @brief Busy poll benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Ping-pong latency of a request written to a pty and its echo read back,
+ * with blocking receive waits and with busy polling for several spin
+ * budgets. With more than one CPU a further run pins the reading thread to
+ * the last CPU. The spin hits and misses show which part of the echoes
+ * arrived within the budget. On a single CPU the spinning thread competes
+ * with the echoing peer, so busy polling only pays off with a core to spare.
+ */
+
+
+#include "serial.hpp"
+#include "bench.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+
+
+#define BENCH_ROUND_TRIPS                       20000
+#define BENCH_PAYLOAD_SIZE                      16
+
+
+static void bench_ping_pong(float budget, int cpu)
+{
+    bench::PtyPair pty;
+    bench::Peer peer(pty.master_fd, bench::Peer::Mode::LOOPBACK);
+    serial::Serial port(pty.name, 1000000, 5.0);
+    port.settle_policy(serial::SettlePolicy::NONE);
+    port.open();
+    port.busy_poll(budget, cpu, 0);
+    
+    std::vector<uint8_t> request(BENCH_PAYLOAD_SIZE, 0x55);
+    std::vector<uint8_t> response(BENCH_PAYLOAD_SIZE);
+    std::vector<double> samples;
+    samples.reserve(BENCH_ROUND_TRIPS);
+    port.reset_stats();
+    
+    for(size_t i = 0; i < BENCH_ROUND_TRIPS; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        port.write(request);
+        port.read_into(response);
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    
+    serial::SerialStats stats = port.stats();
+    
+    bench::Record("busy_poll_ping_pong").add("budget_us", budget * 1e6).add("cpu", (double)cpu)
+        .add("p50_us", bench::percentile(samples, 0.5)).add("p99_us", bench::percentile(samples, 0.99))
+        .add("p999_us", bench::percentile(samples, 0.999)).add("max_us", samples.back())
+        .add("spin_hits", (double)stats.spin_hits).add("spin_misses", (double)stats.spin_misses)
+        .add("rx_syscalls_per_op", (double)stats.rx_syscalls / BENCH_ROUND_TRIPS).print();
+    
+    port.close();
+}
+
+
+int main(void)
+{
+    const float budgets[] = {0.0, 10e-6, 50e-6, 200e-6};
+    unsigned cpus = std::thread::hardware_concurrency();
+    
+    try
+    {
+        for(float budget : budgets)
+            bench_ping_pong(budget, -1);
+        
+        if(cpus > 1)
+            bench_ping_pong(budgets[3], cpus - 1);                                          // the echoing peer keeps the other CPUs
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+
+
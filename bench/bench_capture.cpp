@@ -0,0 +1,143 @@
+/**
+ * @file bench_capture.cpp
+ * @brief Capture and replay benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Measures the cost of one record written to a capture file for several
+ * chunk sizes, the throughput of lines written to a pty port and read back
+ * with and without an active capture, and the throughput of a replay, which
+ * plays a capture as fast as possible into a port read with readline.
+ */
+
+
+#include "serial.hpp"
+#include "capture.hpp"
+#include "bench.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+
+#define BENCH_CAPTURE_FILE                      "./bench/capture.bin"
+#define BENCH_CAPTURE_SIZE                      (64 * 1024 * 1024)
+#define BENCH_RECORDS                           1000000
+#define BENCH_LINES                             50000
+#define BENCH_LINE_SIZE                         64                                  // including the terminator
+
+
+static void bench_record(size_t size)
+{
+    size_t records = bench::iterations(BENCH_RECORDS);
+    serial::Capture capture(BENCH_CAPTURE_FILE, BENCH_CAPTURE_SIZE);
+    std::vector<uint8_t> chunk(size, 'x');
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < records; i++)
+        capture.record(serial::CaptureDirection::RX, 0, chunk);
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    bench::Record("capture_record").add("chunk", (double)size).add("ns_per_record", seconds * 1e9 / records)
+        .add("mb_per_s", size * records / seconds / 1e6).print();
+}
+
+
+static void bench_loopback(bool captured)
+{
+    size_t lines = bench::iterations(BENCH_LINES);
+    bench::PtyPair pty;
+    bench::Peer peer(pty.master_fd, bench::Peer::Mode::LOOPBACK);
+    serial::Serial port(pty.name, 115200, 5.0);
+    port.settle_policy(serial::SettlePolicy::NONE);
+    port.open();
+    
+    serial::Capture capture;
+    
+    if(captured == true)
+    {
+        capture = serial::Capture(BENCH_CAPTURE_FILE, BENCH_CAPTURE_SIZE);
+        port.capture(capture);
+    }
+    
+    std::string line(BENCH_LINE_SIZE - 1, 'a');
+    line += '\n';
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < lines; i++)
+    {
+        port.write(line);
+        
+        if(port.readline() != line)
+            throw std::runtime_error("loopback mismatch");
+    }
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    bench::Record("capture_loopback").add("capture", (captured == true) ? "on" : "off").add("lines_per_s", lines / seconds)
+        .add("captured_bytes", (double)capture.written()).print();
+    
+    port.close();
+}
+
+
+static void bench_replay(void)
+{
+    size_t lines = bench::iterations(BENCH_LINES);
+    {
+        serial::Capture capture(BENCH_CAPTURE_FILE, BENCH_CAPTURE_SIZE);
+        std::string line(BENCH_LINE_SIZE - 1, 'a');
+        line += '\n';
+        
+        for(size_t i = 0; i < lines; i++)
+            capture.record(serial::CaptureDirection::RX, 0, std::span<const uint8_t>((const uint8_t*)line.data(), line.size()));
+    }
+    
+    serial::CaptureReplay replay(BENCH_CAPTURE_FILE);
+    serial::Serial port(replay.port(), 115200, 5.0);
+    port.settle_policy(serial::SettlePolicy::NONE);
+    port.open();
+    replay.speed(0.0);
+    
+    auto start = std::chrono::steady_clock::now();
+    replay.start();
+    
+    for(size_t i = 0; i < lines; i++)
+        port.readline();
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    bench::Record("capture_replay").add("speed", "max").add("lines_per_s", lines / seconds)
+        .add("mb_per_s", replay.replayed() / seconds / 1e6).print();
+    
+    replay.stop();
+    port.close();
+}
+
+
+int main(void)
+{
+    const size_t chunk_sizes[] = {16, 256, 4096};
+    
+    try
+    {
+        for(size_t size : chunk_sizes)
+            bench_record(size);
+        
+        bench_loopback(false);
+        bench_loopback(true);
+        bench_replay();
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+
+
@@ -0,0 +1,135 @@
+/**
+ * @file bench_crc.cpp
+ * @brief CRC kernel benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Compares the byte table, slicing-by-8 and hardware kernels for CRC-16/CCITT,
+ * CRC-32 and CRC-32C on frame sized buffers and on a multi-megabyte buffer.
+ * Before, every kernel is checked against the byte table for unaligned starts
+ * and lengths from 0 to 257 and against the standard check values of
+ * "123456789", the benchmark fails on a mismatch.
+ */
+
+
+#include "crc.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <cstring>
+
+
+#define BENCH_TOTAL_SIZE                        (256UL * 1024UL * 1024UL)           // bytes processed per measurement
+#define BENCH_VERIFY_SIZE                       257                                 // longest checked length, crosses the blocks of the kernels
+#define BENCH_VERIFY_OFFSETS                    16                                  // checked start offsets, all alignments of the wide loads
+
+
+static void run(const char* name, serial::Crc type, serial::CrcKernel kernel, const std::vector<uint8_t>& data, size_t frame_size)
+{
+    size_t repetitions = BENCH_TOTAL_SIZE / data.size();
+    uint32_t check = 0;
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t r = 0; r < repetitions; r++)
+    {
+        for(size_t pos = 0; pos + frame_size <= data.size(); pos += frame_size)             // one check value per frame
+            check += serial::crc(type, kernel, data.data() + pos, frame_size);
+    }
+    
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double throughput = (double)data.size() * repetitions / elapsed.count() / 1e9;
+    
+    std::cout << "    " << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(8) << throughput << " GB/s  (" << std::hex << check << std::dec << ")" << std::endl;
+}
+
+
+// compare every kernel with the byte table and the check values of the CRC catalogue, returns the mismatches
+static size_t verify(const std::vector<uint8_t>& data)
+{
+    const serial::Crc types[] = {serial::Crc::CRC16_CCITT, serial::Crc::CRC16_MODBUS, serial::Crc::CRC32, serial::Crc::CRC32C};
+    const char* type_names[] = {"CRC-16/CCITT", "CRC-16/MODBUS", "CRC-32", "CRC-32C"};
+    const uint32_t check_values[] = {0x29B1, 0x4B37, 0xCBF43926, 0xE3069283};
+    const serial::CrcKernel kernels[] = {serial::CrcKernel::TABLE, serial::CrcKernel::SLICING_BY_8, serial::CrcKernel::HARDWARE};
+    const char* kernel_names[] = {"table", "slicing-by-8", "hardware"};
+    const char* check_input = "123456789";
+    size_t errors = 0;
+    
+    for(int t = 0; t < 4; t++)
+    {
+        for(int k = 0; k < 3; k++)
+        {
+            if(serial::crc_kernel_supported(types[t], kernels[k]) == false)
+                continue;
+            
+            uint32_t check = serial::crc(types[t], kernels[k], (const uint8_t*)check_input, std::strlen(check_input));
+            
+            if(check != check_values[t])
+            {
+                std::cerr << type_names[t] << " " << kernel_names[k] << ": check value " << std::hex << check << " instead of " << check_values[t] << std::dec << std::endl;
+                errors++;
+            }
+            
+            for(size_t offset = 0; offset < BENCH_VERIFY_OFFSETS; offset++)
+            {
+                for(size_t size = 0; size <= BENCH_VERIFY_SIZE; size++)
+                {
+                    uint32_t expected = serial::crc(types[t], serial::CrcKernel::TABLE, data.data() + offset, size);
+                    
+                    if(serial::crc(types[t], kernels[k], data.data() + offset, size) != expected || serial::crc(types[t], data.data() + offset, size) != expected)
+                    {
+                        std::cerr << type_names[t] << " " << kernel_names[k] << ": mismatch at offset " << offset << ", size " << size << std::endl;
+                        errors++;
+                    }
+                }
+            }
+        }
+    }
+    
+    return errors;
+}
+
+
+int main(void)
+{
+    std::vector<uint8_t> data(16 * 1024 * 1024);
+    uint32_t state = 12345;
+    
+    for(size_t i = 0; i < data.size(); i++)
+    {
+        state = state * 1103515245UL + 12345UL;
+        data[i] = state >> 16;
+    }
+    
+    if(verify(data) > 0)
+        return 1;
+    
+    const serial::Crc types[] = {serial::Crc::CRC16_CCITT, serial::Crc::CRC32, serial::Crc::CRC32C};
+    const char* type_names[] = {"CRC-16/CCITT", "CRC-32", "CRC-32C"};
+    const serial::CrcKernel kernels[] = {serial::CrcKernel::TABLE, serial::CrcKernel::SLICING_BY_8, serial::CrcKernel::HARDWARE};
+    const char* kernel_names[] = {"table", "slicing-by-8", "hardware"};
+    
+    for(size_t frame_size : {64UL, 256UL, 4096UL, data.size()})
+    {
+        std::cout << "frame size: " << frame_size << " B" << std::endl;
+        
+        for(int t = 0; t < 3; t++)
+        {
+            std::cout << "  " << type_names[t] << std::endl;
+            
+            for(int k = 0; k < 3; k++)
+            {
+                if(serial::crc_kernel_supported(types[t], kernels[k]) == true)
+                    run(kernel_names[k], types[t], kernels[k], data, frame_size);
+            }
+        }
+    }
+    
+    return 0;
+}
+
+
+
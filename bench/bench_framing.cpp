@@ -0,0 +1,176 @@
+/**
+ * @file bench_framing.cpp
+ * @brief Frame stream benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Frames per second for COBS, SLIP and length-prefixed frames over a pty
+ * loopback. For receiving a thread feeds pre-encoded frames into the master
+ * side, for sending a thread drains the master side.
+ */
+
+
+#include "serial.hpp"
+#include "framing.hpp"
+#include "bench.hpp"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <pty.h>
+#include <unistd.h>
+#include <poll.h>
+
+
+#define BENCH_FRAMES                            100000
+
+
+static void encode(serial::Framing framing, std::span<const uint8_t> payload, std::vector<uint8_t>& output)
+{
+    if(framing == serial::Framing::COBS)
+        serial::cobs_encode(payload, output);
+    else if(framing == serial::Framing::SLIP)
+        serial::slip_encode(payload, output);
+    else
+    {
+        output.push_back(payload.size() >> 8);
+        output.push_back(payload.size());
+        output.insert(output.end(), payload.begin(), payload.end());
+    }
+}
+
+
+static void feed_loop(int master_fd, const std::vector<uint8_t>* stream)
+{
+    size_t offset = 0;
+    
+    while(offset < stream->size())
+    {
+        ssize_t num = ::write(master_fd, stream->data() + offset, stream->size() - offset);
+        
+        if(num > 0)
+            offset += num;
+    }
+}
+
+
+static void drain_loop(int master_fd, std::atomic<bool>* stop)
+{
+    uint8_t buffer[65536];
+    struct pollfd poll_fd = {master_fd, POLLIN, 0};
+    
+    while(*stop == false)
+    {
+        if(poll(&poll_fd, 1, 100) > 0 && ::read(master_fd, buffer, sizeof(buffer)) < 0)
+            break;
+    }
+}
+
+
+static const char* framing_name(serial::Framing framing)
+{
+    if(framing == serial::Framing::COBS)
+        return "cobs";
+    else if(framing == serial::Framing::SLIP)
+        return "slip";
+    else
+        return "length prefix";
+}
+
+
+static void bench_receive(serial::Serial& port, int master_fd, serial::Framing framing, size_t payload_size)
+{
+    size_t count = bench::iterations(BENCH_FRAMES);
+    std::vector<uint8_t> payload(payload_size);
+    std::vector<uint8_t> stream;
+    
+    for(size_t i = 0; i < payload_size; i++)
+        payload[i] = (i % 5 == 0) ? 0x00 : ((i % 7 == 0) ? 0xC0 : i);                      // some bytes that need stuffing
+    
+    for(size_t i = 0; i < count; i++)
+        encode(framing, payload, stream);
+    
+    serial::FrameStream frames(port, framing);
+    size_t received = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::thread feeder(feed_loop, master_fd, &stream);
+    
+    for(size_t i = 0; i < count; i++)
+        received += frames.read_frame().size();
+    
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    feeder.join();
+    
+    if(received != count * payload_size)
+        throw std::runtime_error("receive mismatch");
+    
+    std::cout << "  receive " << std::setw(14) << framing_name(framing) << std::setw(6) << payload_size << " B  "
+              << std::fixed << std::setprecision(0) << std::setw(10) << count / elapsed.count() << " frames/s  "
+              << std::setprecision(1) << std::setw(7) << received / elapsed.count() / 1e6 << " MB/s" << std::endl;
+}
+
+
+static void bench_send(serial::Serial& port, serial::Framing framing, size_t payload_size)
+{
+    size_t count = bench::iterations(BENCH_FRAMES);
+    std::vector<uint8_t> payload(payload_size, 0xC0);
+    serial::FrameStream frames(port, framing);
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < count; i++)
+        frames.write_frame(payload);
+    
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    
+    std::cout << "  send    " << std::setw(14) << framing_name(framing) << std::setw(6) << payload_size << " B  "
+              << std::fixed << std::setprecision(0) << std::setw(10) << count / elapsed.count() << " frames/s" << std::endl;
+}
+
+
+int main(void)
+{
+    int master_fd;
+    int slave_fd;
+    char name[64];
+    
+    if(openpty(&master_fd, &slave_fd, name, NULL, NULL) != 0)
+    {
+        std::cerr << "openpty failed" << std::endl;
+        return 1;
+    }
+    
+    serial::Serial port(name, 115200, 5.0);
+    port.open();
+    std::cout << bench::iterations(BENCH_FRAMES) << " frames per run over a pty loopback" << std::endl;
+    
+    for(serial::Framing framing : {serial::Framing::COBS, serial::Framing::SLIP, serial::Framing::LENGTH_PREFIX})
+    {
+        for(size_t payload_size : {16, 64, 256})
+            bench_receive(port, master_fd, framing, payload_size);
+    }
+    
+    std::atomic<bool> stop(false);
+    std::thread drain(drain_loop, master_fd, &stop);
+    
+    for(serial::Framing framing : {serial::Framing::COBS, serial::Framing::SLIP, serial::Framing::LENGTH_PREFIX})
+    {
+        for(size_t payload_size : {16, 64, 256})
+            bench_send(port, framing, payload_size);
+    }
+    
+    stop = true;
+    drain.join();
+    port.close();
+    ::close(slave_fd);
+    ::close(master_fd);
+    
+    return 0;
+}
+
+
+
@@ -0,0 +1,135 @@
+/**
+ * @file bench_latency.cpp
+ * @brief Round-trip latency benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Ping-pong latency with and without low latency mode. Without argument a
+ * pty pair with an echo thread is used as stand-in device. With a port as
+ * argument, e.g. /dev/ttyUSB0, TX and RX of the adapter must be connected.
+ */
+
+
+#include "serial.hpp"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+
+#include <pty.h>
+#include <unistd.h>
+#include <poll.h>
+
+
+#define BENCH_ROUND_TRIPS                       2000
+
+
+static void echo_loop(int master_fd, std::atomic<bool>* stop)
+{
+    uint8_t buffer[4096];
+    struct pollfd poll_fd = {master_fd, POLLIN, 0};
+    
+    while(*stop == false)
+    {
+        if(poll(&poll_fd, 1, 100) <= 0)
+            continue;
+        
+        ssize_t num = ::read(master_fd, buffer, sizeof(buffer));
+        
+        if(num > 0 && ::write(master_fd, buffer, num) != num)
+            break;
+    }
+}
+
+
+static void ping_pong(serial::Serial& port, size_t payload_size)
+{
+    std::vector<uint8_t> request(payload_size, 0x55);
+    std::vector<uint8_t> response(payload_size);
+    std::vector<double> round_trips;
+    
+    for(int i = 0; i < BENCH_ROUND_TRIPS; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        port.write(request);
+        port.read_into(response);
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        round_trips.push_back(elapsed.count());
+    }
+    
+    std::sort(round_trips.begin(), round_trips.end());
+    
+    std::cout << std::setw(6) << payload_size << " B" << std::fixed << std::setprecision(1)
+              << "  p50 " << std::setw(9) << round_trips[round_trips.size() / 2] << " us"
+              << "  p99 " << std::setw(9) << round_trips[round_trips.size() * 99 / 100] << " us"
+              << "  max " << std::setw(9) << round_trips.back() << " us" << std::endl;
+}
+
+
+int main(int argc, char** argv)
+{
+    std::string port_name;
+    int master_fd = -1;
+    int slave_fd = -1;
+    std::atomic<bool> stop(false);
+    std::thread echo;
+    
+    if(argc > 1)
+        port_name = argv[1];
+    else
+    {
+        char name[64];
+        
+        if(openpty(&master_fd, &slave_fd, name, NULL, NULL) != 0)
+        {
+            std::cerr << "openpty failed" << std::endl;
+            return 1;
+        }
+        
+        port_name = name;
+        echo = std::thread(echo_loop, master_fd, &stop);
+    }
+    
+    serial::Serial port(port_name, 115200, 1.0);
+    port.open();
+    std::cout << "port: " << port_name << ((argc > 1) ? "" : " (pty with echo thread)") << std::endl;
+    
+    for(bool state : {false, true})
+    {
+        serial::LowLatencyStatus status = port.low_latency(state);
+        
+        std::cout << "low latency " << (state ? "on" : "off") << ": ASYNC_LOW_LATENCY "
+                  << (status.async_low_latency ? "set" : "not set") << ", latency timer ";
+        
+        if(status.latency_timer < 0)
+            std::cout << "not available" << std::endl;
+        else
+            std::cout << status.latency_timer << " ms" << std::endl;
+        
+        if(status.serial_error != 0)
+            std::cout << "TIOCSSERIAL rejected with errno " << status.serial_error << std::endl;
+        
+        for(size_t payload_size : {1, 16, 64})
+            ping_pong(port, payload_size);
+    }
+    
+    port.close();
+    
+    if(echo.joinable() == true)
+    {
+        stop = true;
+        echo.join();
+        ::close(slave_fd);
+        ::close(master_fd);
+    }
+    
+    return 0;
+}
+
+
+
@@ -0,0 +1,337 @@
+/**
+ * @file bench_modbus.cpp
+ * @brief Modbus RTU polling benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Polls holding registers of simulated slaves on 1 to 32 pty buses at 115200
+ * and 1000000 Bd. One simulator thread serves all buses and answers after the
+ * time the request and the response take on the wire at the baudrate, so the
+ * numbers include the transmission time of a real bus. Compares a write with
+ * a read guarded by the timeout, one bus after the other, the ModbusMaster,
+ * also one bus after the other, and the ModbusPoller, which polls all buses
+ * concurrently. A slave, which sends its response in two writes with a pause
+ * longer than the inter-frame gap like a USB adapter, checks that the master
+ * waits for a response of known length, the benchmark fails on errors.
+ */
+
+
+#include "serial.hpp"
+#include "modbus.hpp"
+#include "crc.hpp"
+#include "bench.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+
+
+#define BENCH_CYCLE_TIME                        1.0                                 // seconds per measurement
+#define BENCH_REGISTERS                         10                                  // registers per poll
+#define BENCH_SLAVE                             1
+#define BENCH_SPLIT_PAUSE                       5                                   // pause in ms between the two writes of a split response
+
+
+// slave simulator, answers read holding registers requests on all buses after their wire time
+class SlaveSimulator
+{
+private:
+    struct Bus
+    {
+        int fd;
+        std::vector<uint8_t> input;
+        std::vector<uint8_t> response;
+        std::chrono::steady_clock::time_point due;      // time at which the response is sent
+        size_t sent;                                    // bytes of the response written
+        bool pending_flag;
+    };
+    
+    std::vector<Bus> buses;
+    uint32_t baudrate;
+    std::chrono::nanoseconds split_pause;               // 0 to send the response with one write
+    std::thread thread;
+    std::atomic<bool> stop_flag;
+    
+    std::chrono::nanoseconds wire_time(size_t size)
+    {
+        return std::chrono::nanoseconds((uint64_t)size * 10 * 1000000000 / this->baudrate);
+    }
+    
+    void handle(Bus& bus)
+    {
+        if(bus.input.size() < 8)
+            return;
+        
+        if(bus.input[0] != BENCH_SLAVE || bus.input[1] != 0x03 || serial::crc_check(serial::Crc::CRC16_MODBUS, bus.input.data(), 8) == false)
+        {
+            bus.input.clear();                                                              // resynchronize, the master times out
+            return;
+        }
+        
+        uint16_t address = (bus.input[2] << 8) | bus.input[3];
+        uint16_t count = (bus.input[4] << 8) | bus.input[5];
+        
+        bus.response.assign({BENCH_SLAVE, 0x03, (uint8_t)(2 * count)});
+        
+        for(uint16_t i = 0; i < count; i++)                                                 // register value is its address
+        {
+            bus.response.push_back((address + i) >> 8);
+            bus.response.push_back(address + i);
+        }
+        
+        uint8_t check[2];
+        serial::crc_store(serial::Crc::CRC16_MODBUS, serial::crc(serial::Crc::CRC16_MODBUS, bus.response.data(), bus.response.size()), check);
+        bus.response.insert(bus.response.end(), check, check + 2);
+        
+        bus.due = std::chrono::steady_clock::now() + this->wire_time(8 + bus.response.size());
+        bus.sent = 0;
+        bus.pending_flag = true;
+        bus.input.erase(bus.input.begin(), bus.input.begin() + 8);
+    }
+    
+    void loop(void)
+    {
+        std::vector<struct pollfd> poll_fds(this->buses.size());
+        
+        for(size_t i = 0; i < this->buses.size(); i++)
+            poll_fds[i] = {this->buses[i].fd, POLLIN, 0};
+        
+        while(this->stop_flag == false)
+        {
+            auto now = std::chrono::steady_clock::now();
+            std::chrono::nanoseconds wait = std::chrono::milliseconds(50);
+            
+            for(Bus& bus : this->buses)
+            {
+                if(bus.pending_flag == true && bus.due <= now)
+                {
+                    size_t size = bus.response.size() - bus.sent;
+                    
+                    if(this->split_pause.count() > 0 && bus.sent == 0)                      // first half, the rest follows after the pause
+                        size /= 2;
+                    
+                    if(::write(bus.fd, bus.response.data() + bus.sent, size) < 0)
+                        return;
+                    
+                    bus.sent += size;
+                    bus.pending_flag = (bus.sent < bus.response.size());
+                    bus.due = now + this->split_pause;
+                    
+                    if(bus.pending_flag == true && this->split_pause < wait)
+                        wait = this->split_pause;
+                }
+                else if(bus.pending_flag == true && bus.due - now < wait)
+                    wait = bus.due - now;
+            }
+            
+            struct timespec timeout = {0, (long)wait.count()};
+            
+            if(ppoll(poll_fds.data(), poll_fds.size(), &timeout, NULL) <= 0)
+                continue;
+            
+            for(size_t i = 0; i < poll_fds.size(); i++)
+            {
+                if((poll_fds[i].revents & POLLIN) == 0)
+                    continue;
+                
+                uint8_t buffer[512];
+                ssize_t num = ::read(this->buses[i].fd, buffer, sizeof(buffer));
+                
+                if(num <= 0)
+                    return;
+                
+                this->buses[i].input.insert(this->buses[i].input.end(), buffer, buffer + num);
+                this->handle(this->buses[i]);
+            }
+        }
+    }
+public:
+    SlaveSimulator(std::vector<int> fds, uint32_t baudrate, std::chrono::nanoseconds split_pause) : baudrate(baudrate), split_pause(split_pause), stop_flag(false)
+    {
+        for(int fd : fds)
+            this->buses.push_back({fd, {}, {}, {}, 0, false});
+        
+        this->thread = std::thread(&SlaveSimulator::loop, this);
+    }
+    
+    ~SlaveSimulator(void)
+    {
+        this->stop_flag = true;
+        this->thread.join();
+    }
+};
+
+
+static void report(const char* mode, size_t buses, uint32_t baudrate, size_t polls, size_t errors, double seconds)
+{
+    bench::Record("modbus_poll").add("mode", mode).add("buses", (double)buses).add("baudrate", (double)baudrate)
+        .add("polls_per_s", polls / seconds).add("registers_per_s", polls * BENCH_REGISTERS / seconds).add("errors", (double)errors).print();
+}
+
+
+static void bench_modbus(size_t num, uint32_t baudrate)
+{
+    std::vector<std::unique_ptr<bench::PtyPair>> ptys;
+    std::vector<std::unique_ptr<serial::Serial>> ports;
+    std::vector<std::unique_ptr<serial::ModbusMaster>> masters;
+    std::vector<int> master_fds;
+    
+    for(size_t i = 0; i < num; i++)
+    {
+        ptys.push_back(std::make_unique<bench::PtyPair>());
+        ports.push_back(std::make_unique<serial::Serial>(ptys[i]->name, baudrate, 1.0));
+        ports[i]->settle_policy(serial::SettlePolicy::NONE);
+        ports[i]->open();
+        masters.push_back(std::make_unique<serial::ModbusMaster>(*ports[i]));
+        master_fds.push_back(ptys[i]->master_fd);
+    }
+    
+    SlaveSimulator simulator(master_fds, baudrate, std::chrono::nanoseconds(0));
+    uint8_t request[8] = {BENCH_SLAVE, 0x03, 0x00, 0x00, 0x00, BENCH_REGISTERS};
+    serial::crc_store(serial::Crc::CRC16_MODBUS, serial::crc(serial::Crc::CRC16_MODBUS, request, 6), request + 6);
+    
+    size_t polls = 0;
+    size_t errors = 0;
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0.0;
+    
+    while(seconds < bench::duration(BENCH_CYCLE_TIME))                                      // write, then read with the timeout as guard
+    {
+        for(size_t i = 0; i < num; i++)
+        {
+            try
+            {
+                ports[i]->write(std::span<const uint8_t>(request, sizeof(request)));
+                std::vector<uint8_t> response = ports[i]->read(5 + 2 * BENCH_REGISTERS);
+                errors += (serial::crc_check(serial::Crc::CRC16_MODBUS, response.data(), response.size()) == false);
+            }
+            catch(const serial::SerialTimeoutException&)
+            {
+                errors++;
+            }
+            
+            polls++;
+        }
+        
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    
+    report("write_read", num, baudrate, polls, errors, seconds);
+    
+    uint16_t registers[BENCH_REGISTERS];
+    polls = 0;
+    errors = 0;
+    seconds = 0.0;
+    start = std::chrono::steady_clock::now();
+    
+    while(seconds < bench::duration(BENCH_CYCLE_TIME))
+    {
+        for(size_t i = 0; i < num; i++)
+        {
+            errors += (masters[i]->read_holding_registers(BENCH_SLAVE, 0, registers) != serial::ModbusStatus::OK || registers[BENCH_REGISTERS - 1] != BENCH_REGISTERS - 1);
+            polls++;
+        }
+        
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    
+    report("master", num, baudrate, polls, errors, seconds);
+    
+    serial::ModbusPoller poller;
+    
+    for(size_t i = 0; i < num; i++)
+        poller.add(*masters[i], BENCH_SLAVE, 0x03, 0, BENCH_REGISTERS);
+    
+    polls = 0;
+    errors = 0;
+    seconds = 0.0;
+    start = std::chrono::steady_clock::now();
+    
+    while(seconds < bench::duration(BENCH_CYCLE_TIME))
+    {
+        errors += num - poller.run_cycle();
+        polls += num;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    
+    report("poller", num, baudrate, polls, errors, seconds);
+    
+    for(size_t i = 0; i < num; i++)
+        ports[i]->close();
+}
+
+
+// responses split by a pause longer than the gap must still be complete, returns the errors
+static size_t bench_split(uint32_t baudrate)
+{
+    bench::PtyPair pty;
+    serial::Serial port(pty.name, baudrate, 1.0);
+    port.settle_policy(serial::SettlePolicy::NONE);
+    port.open();
+    
+    serial::ModbusMaster master(port);
+    SlaveSimulator simulator({pty.master_fd}, baudrate, std::chrono::milliseconds(BENCH_SPLIT_PAUSE));
+    uint16_t registers[BENCH_REGISTERS];
+    size_t polls = 0;
+    size_t errors = 0;
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0.0;
+    
+    while(seconds < bench::duration(BENCH_CYCLE_TIME))
+    {
+        errors += (master.read_holding_registers(BENCH_SLAVE, 0, registers) != serial::ModbusStatus::OK || registers[BENCH_REGISTERS - 1] != BENCH_REGISTERS - 1);
+        polls++;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    
+    report("master_split", 1, baudrate, polls, errors, seconds);
+    port.close();
+    
+    return errors;
+}
+
+
+int main(void)
+{
+    const uint32_t baudrates[] = {115200, 1000000};
+    const size_t bus_counts[] = {1, 8, 32};
+    
+    try
+    {
+        for(uint32_t baudrate : baudrates)
+        {
+            for(size_t num : bus_counts)
+                bench_modbus(num, baudrate);
+        }
+        
+        size_t errors = 0;
+        
+        for(uint32_t baudrate : baudrates)
+            errors += bench_split(baudrate);
+        
+        if(errors > 0)
+        {
+            std::cerr << errors << " split responses not received completely" << std::endl;
+            return 1;
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+
+
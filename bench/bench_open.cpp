@@ -0,0 +1,99 @@
+/**
+ * @file bench_open.cpp
+ * @brief Port bring-up benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Time until N pty ports are open: one open call after the other, open_all
+ * with the default settle policy and open_all without settle time. One
+ * additional port name does not exist, to show that it fails on its own.
+ */
+
+
+#include "serial.hpp"
+#include "bench.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+static void bench_open(size_t num)
+{
+    std::vector<std::unique_ptr<bench::PtyPair>> ptys;
+    std::vector<std::unique_ptr<serial::Serial>> ports;
+    std::vector<serial::Serial*> port_list;
+    
+    for(size_t i = 0; i < num; i++)
+    {
+        ptys.push_back(std::make_unique<bench::PtyPair>());
+        ports.push_back(std::make_unique<serial::Serial>(ptys[i]->name, 115200, 1.0));
+        port_list.push_back(ports[i].get());
+    }
+    
+    serial::Serial missing("/dev/does-not-exist", 115200);
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < num; i++)
+        ports[i]->open();
+    
+    bench::Record("open").add("mode", "sequential").add("ports", (double)num).add("ms", elapsed_ms(start)).print();
+    
+    for(size_t i = 0; i < num; i++)
+        ports[i]->close();
+    
+    port_list.push_back(&missing);
+    
+    const serial::SettlePolicy policies[] = {serial::SettlePolicy::FIXED, serial::SettlePolicy::NONE};
+    
+    for(serial::SettlePolicy policy : policies)
+    {
+        for(size_t i = 0; i < num; i++)
+            ports[i]->settle_policy(policy);
+        
+        start = std::chrono::steady_clock::now();
+        std::vector<serial::OpenResult> results = serial::Serial::open_all(port_list);
+        double ms = elapsed_ms(start);
+        size_t failed = 0;
+        
+        for(size_t i = 0; i < results.size(); i++)
+            failed += (results[i].success == false);
+        
+        bench::Record("open").add("mode", (policy == serial::SettlePolicy::FIXED) ? "open_all" : "open_all_no_settle")
+            .add("ports", (double)num).add("ms", ms).add("failed", (double)failed).print();
+        
+        for(size_t i = 0; i < num; i++)
+            ports[i]->close();
+    }
+}
+
+
+int main(void)
+{
+    const size_t port_counts[] = {1, 16, 64, 200};
+    
+    try
+    {
+        for(size_t num : port_counts)
+            bench_open(num);
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+
+
@@ -0,0 +1,171 @@
+/**
+ * @file bench_pool.cpp
+ * @brief Buffer pool benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Reads a continuous stream of lines from a pty with readline and read,
+ * which return new containers, and with readline_pooled and read_pooled,
+ * which return buffers of a pool. Heap allocations are counted by replacing
+ * the global operator new in the thread running the benchmark, the buffers
+ * taken from the pool by a counting memory resource. Both are measured after
+ * a warm-up, so they show the steady state. The benchmark fails if a pooled
+ * read allocates in the steady state.
+ */
+
+
+#include "serial.hpp"
+#include "buffer_pool.hpp"
+#include "bench.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory_resource>
+#include <chrono>
+#include <new>
+#include <cstdlib>
+#include <cstdint>
+
+
+#define BENCH_WARM_UP                           1000
+#define BENCH_OPS                               100000
+#define BENCH_LINE                              "0123456789abcdef0123456789abcdef0123456789abcde\n"
+
+
+static thread_local uint64_t allocation_count = 0;
+
+
+void* operator new(size_t size)
+{
+    allocation_count++;
+    
+    void* memory = std::malloc(size ? size : 1);
+    
+    if(memory == NULL)
+        throw std::bad_alloc();
+    
+    return memory;
+}
+
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+
+// passes the requests to new/delete and counts them
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    uint64_t count = 0;
+private:
+    void* do_allocate(size_t size, size_t alignment) override
+    {
+        this->count++;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+    
+    void do_deallocate(void* memory, size_t size, size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(memory, size, alignment);
+    }
+    
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+
+// returns false if a pooled read allocated from the heap or from the pool after the warm-up
+template <typename Operation>
+static bool measure(const char* api, bool pooled, serial::Serial& port, CountingResource& resource, Operation operation)
+{
+    for(int i = 0; i < BENCH_WARM_UP; i++)
+        operation(port);
+    
+    uint64_t allocations = allocation_count;
+    uint64_t pool_allocations = resource.count;
+    auto start = std::chrono::steady_clock::now();
+    
+    for(int i = 0; i < BENCH_OPS; i++)
+        operation(port);
+    
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    allocations = allocation_count - allocations;                                           // before the record allocates
+    pool_allocations = resource.count - pool_allocations;
+    
+    bench::Record("receive_allocations").add("api", api).add("ns_per_op", elapsed.count() / BENCH_OPS)
+        .add("allocs_per_op", (double)allocations / BENCH_OPS).add("pool_allocs", (double)pool_allocations).print();
+    
+    if(pooled == true && (allocations > 0 || pool_allocations > 0))
+    {
+        std::cerr << api << ": " << allocations << " heap and " << pool_allocations << " pool allocations in the steady state" << std::endl;
+        return false;
+    }
+    
+    return true;
+}
+
+
+int main(void)
+{
+    const size_t line_size = sizeof(BENCH_LINE) - 1;
+    bool passed = true;
+    
+    try
+    {
+        bench::PtyPair pty;
+        std::string line = BENCH_LINE;
+        bench::Peer peer(pty.master_fd, bench::Peer::Mode::FEED, std::vector<uint8_t>(line.begin(), line.end()));
+        
+        CountingResource resource;
+        serial::Serial port(pty.name, 115200, 5.0);
+        port.buffer_pool(serial::BufferPool(&resource));
+        port.open();
+        port.readline();                                                                    // the first line may be incomplete
+        
+        passed &= measure("readline", false, port, resource, [](serial::Serial& port) {
+            port.readline();
+        });
+        
+        passed &= measure("readline_pooled", true, port, resource, [](serial::Serial& port) {
+            port.readline_pooled();
+        });
+        
+        passed &= measure("read", false, port, resource, [line_size](serial::Serial& port) {
+            port.read(line_size);
+        });
+        
+        passed &= measure("read_pooled", true, port, resource, [line_size](serial::Serial& port) {
+            port.read_pooled(line_size);
+        });
+        
+        std::vector<serial::PooledBuffer> held;
+        
+        // keeps 64 lines alive, like a queue of messages
+        passed &= measure("readline_pooled_held", true, port, resource, [&held](serial::Serial& port) {
+            held.push_back(port.readline_pooled());
+            
+            if(held.size() == 64)
+                held.clear();
+        });
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    
+    return (passed == true) ? 0 : 1;
+}
+
+
+
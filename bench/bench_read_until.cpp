@@ -0,0 +1,145 @@
+/**
+ * @file bench_read_until.cpp
+ * @brief Delimiter search benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Compares the delimiter search kernels used by read_until with a naive byte
+ * loop on multi-megabyte buffers of ASCII telemetry.
+ */
+
+
+#include "byte_search.hpp"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+
+
+#define BENCH_BUFFER_SIZE                       (16UL * 1024UL * 1024UL)
+#define BENCH_REPETITIONS                       20
+
+
+static const uint8_t* find_naive(const uint8_t* data, size_t size, const uint8_t* pattern, size_t pattern_size)
+{
+    for(size_t i = 0; i + pattern_size <= size; i++)
+    {
+        size_t j = 0;
+        
+        while(j < pattern_size && data[i + j] == pattern[j])
+            j++;
+        
+        if(j == pattern_size)
+            return data + i;
+    }
+    
+    return NULL;
+}
+
+
+static std::vector<uint8_t> telemetry(size_t size, size_t line_length, const std::string& terminator)
+{
+    std::vector<uint8_t> data(size);
+    uint32_t state = 12345;
+    
+    for(size_t i = 0; i < size; i++)
+    {
+        state = state * 1103515245UL + 12345UL;
+        data[i] = ' ' + ((state >> 16) % 64);                                               // printable characters without '\r' and '\n'
+    }
+    
+    if(line_length > 0)
+    {
+        for(size_t i = line_length; i + terminator.size() <= size; i += line_length)
+            std::memcpy(&data[i - terminator.size()], terminator.data(), terminator.size());
+    }
+    else
+        std::memcpy(&data[size - terminator.size()], terminator.data(), terminator.size());
+    
+    return data;
+}
+
+
+template <typename Finder>
+static void run(const char* name, const std::vector<uint8_t>& data, const std::string& terminator, Finder finder)
+{
+    const uint8_t* pattern = (const uint8_t*)terminator.data();
+    size_t matches = 0;
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    for(int r = 0; r < BENCH_REPETITIONS; r++)
+    {
+        const uint8_t* pos = data.data();
+        const uint8_t* end = data.data() + data.size();
+        
+        while(pos < end)                                                                    // split the whole buffer like consecutive read_until calls
+        {
+            const uint8_t* match = finder(pos, end - pos, pattern, terminator.size());
+            
+            if(match == NULL)
+                break;
+            
+            matches++;
+            pos = match + terminator.size();
+        }
+    }
+    
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double throughput = (double)data.size() * BENCH_REPETITIONS / elapsed.count() / 1e9;
+    
+    std::cout << "  " << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(8) << throughput << " GB/s  (" << matches / BENCH_REPETITIONS << " matches)" << std::endl;
+}
+
+
+static void bench_case(const char* title, size_t line_length, const std::string& terminator)
+{
+    std::vector<uint8_t> data = telemetry(BENCH_BUFFER_SIZE, line_length, terminator);
+    
+    std::cout << title << std::endl;
+    
+    run("naive", data, terminator, find_naive);
+    
+    if(terminator.size() == 1)
+    {
+        run("memchr", data, terminator, [](const uint8_t* d, size_t s, const uint8_t* p, size_t) {
+            return (const uint8_t*)std::memchr(d, p[0], s);
+        });
+    }
+    
+    const serial::SearchKernel kernels[] = {serial::SearchKernel::SCALAR, serial::SearchKernel::SSE2, serial::SearchKernel::AVX2};
+    const char* names[] = {"scalar", "sse2", "avx2"};
+    
+    for(int k = 0; k < 3; k++)
+    {
+        if(serial::search_kernel_supported(kernels[k]) == false)
+            continue;
+        
+        serial::SearchKernel kernel = kernels[k];
+        run(names[k], data, terminator, [kernel](const uint8_t* d, size_t s, const uint8_t* p, size_t n) {
+            return serial::find_sequence(kernel, d, s, p, n);
+        });
+    }
+}
+
+
+int main(void)
+{
+    std::cout << "buffer size: " << BENCH_BUFFER_SIZE / (1024 * 1024) << " MiB" << std::endl;
+    
+    bench_case("single '\\n' at the end", 0, "\n");
+    bench_case("'\\n' every 80 bytes", 80, "\n");
+    bench_case("'\\n' every 1024 bytes", 1024, "\n");
+    bench_case("\"\\r\\n\" at the end", 0, "\r\n");
+    bench_case("\"\\r\\n\" every 80 bytes", 80, "\r\n");
+    bench_case("\"<END>\" every 1024 bytes", 1024, "<END>");
+    
+    return 0;
+}
+
+
+
@@ -0,0 +1,303 @@
+/**
+ * @file bench_serial.cpp
+ * @brief Serial benchmark suite
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Throughput of write, read, readline and readlines, round-trip latency
+ * distribution, system calls and heap allocations per operation for several
+ * payload sizes. A pty pair is used as stand-in device, so no hardware is
+ * necessary. The results are printed as JSON lines. System calls are counted
+ * by wrapping the libc functions at link time (see Makefile), allocations by
+ * replacing the global operator new; both only in the thread running the
+ * benchmark.
+ */
+
+
+#include "serial.hpp"
+#include "bench.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <new>
+#include <cstdlib>
+#include <cstdarg>
+#include <cstdint>
+
+#include <unistd.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <sys/ioctl.h>
+
+
+#define BENCH_BYTES                             (4UL * 1024UL * 1024UL)             // data per throughput measurement
+#define BENCH_MAX_OPS                           20000
+#define BENCH_ROUND_TRIPS                       2000
+
+
+static thread_local uint64_t syscall_count = 0;
+static thread_local uint64_t allocation_count = 0;
+
+
+/* counting wrappers, linked with -Wl,--wrap=<function> */
+
+extern "C"
+{
+    ssize_t __real_read(int fd, void* buffer, size_t size);
+    ssize_t __real_write(int fd, const void* buffer, size_t size);
+    ssize_t __real_writev(int fd, const struct iovec* iov, int count);
+    int __real_poll(struct pollfd* fds, nfds_t count, int timeout);
+    int __real_ppoll(struct pollfd* fds, nfds_t count, const struct timespec* timeout, const sigset_t* mask);
+    int __real_ioctl(int fd, unsigned long request, void* argument);
+    
+    ssize_t __wrap_read(int fd, void* buffer, size_t size)
+    {
+        syscall_count++;
+        return __real_read(fd, buffer, size);
+    }
+    
+    ssize_t __wrap_write(int fd, const void* buffer, size_t size)
+    {
+        syscall_count++;
+        return __real_write(fd, buffer, size);
+    }
+    
+    ssize_t __wrap_writev(int fd, const struct iovec* iov, int count)
+    {
+        syscall_count++;
+        return __real_writev(fd, iov, count);
+    }
+    
+    int __wrap_poll(struct pollfd* fds, nfds_t count, int timeout)
+    {
+        syscall_count++;
+        return __real_poll(fds, count, timeout);
+    }
+    
+    int __wrap_ppoll(struct pollfd* fds, nfds_t count, const struct timespec* timeout, const sigset_t* mask)
+    {
+        syscall_count++;
+        return __real_ppoll(fds, count, timeout, mask);
+    }
+    
+    int __wrap_ioctl(int fd, unsigned long request, ...)
+    {
+        va_list arguments;
+        va_start(arguments, request);
+        void* argument = va_arg(arguments, void*);
+        va_end(arguments);
+        
+        syscall_count++;
+        return __real_ioctl(fd, request, argument);
+    }
+}
+
+
+void* operator new(size_t size)
+{
+    allocation_count++;
+    
+    void* pointer = std::malloc((size > 0) ? size : 1);
+    
+    if(pointer == NULL)
+        throw std::bad_alloc();
+    
+    return pointer;
+}
+
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+
+/* measurement */
+
+struct Counters
+{
+    std::chrono::steady_clock::time_point start;
+    uint64_t syscalls;
+    uint64_t allocations;
+    
+    Counters(void) : start(std::chrono::steady_clock::now()), syscalls(syscall_count), allocations(allocation_count) {}
+};
+
+
+static void report(const char* bench, size_t payload_size, size_t ops, const Counters& counters)
+{
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - counters.start;
+    
+    bench::Record(bench).add("payload", payload_size).add("ops", ops)
+                        .add("ops_per_s", ops / elapsed.count())
+                        .add("mb_per_s", (double)ops * payload_size / elapsed.count() / 1e6)
+                        .add("syscalls_per_op", (double)(syscall_count - counters.syscalls) / ops)
+                        .add("allocs_per_op", (double)(allocation_count - counters.allocations) / ops)
+                        .print();
+}
+
+
+static size_t op_count(size_t payload_size)
+{
+    size_t ops = BENCH_BYTES / payload_size;
+    
+    return (ops < BENCH_MAX_OPS) ? ops : BENCH_MAX_OPS;
+}
+
+
+static std::vector<uint8_t> line_pattern(size_t payload_size)
+{
+    std::vector<uint8_t> pattern(payload_size, 'x');
+    pattern.back() = '\n';
+    
+    return pattern;
+}
+
+
+static void bench_write(size_t payload_size)
+{
+    bench::PtyPair pty;
+    serial::Serial port(pty.name, 115200, 5.0);
+    port.open();
+    
+    bench::Peer peer(pty.master_fd, bench::Peer::Mode::DRAIN);
+    std::vector<uint8_t> payload(payload_size, 0x55);
+    size_t ops = op_count(payload_size);
+    Counters counters;
+    
+    for(size_t i = 0; i < ops; i++)
+        port.write(payload);
+    
+    report("write", payload_size, ops, counters);
+    
+    counters = Counters();
+    
+    for(size_t i = 0; i < ops; i++)
+        port.queue_write(payload);
+    
+    port.flush();
+    report("queue_write", payload_size, ops, counters);
+}
+
+
+static void bench_read(size_t payload_size)
+{
+    bench::PtyPair pty;
+    serial::Serial port(pty.name, 115200, 5.0);
+    port.open();
+    
+    bench::Peer peer(pty.master_fd, bench::Peer::Mode::FEED, line_pattern(payload_size));
+    std::vector<uint8_t> buffer(payload_size);
+    size_t ops = op_count(payload_size);
+    Counters counters;
+    
+    for(size_t i = 0; i < ops; i++)
+        port.read(payload_size);
+    
+    report("read", payload_size, ops, counters);
+    
+    counters = Counters();
+    
+    for(size_t i = 0; i < ops; i++)
+        port.read_into(buffer);
+    
+    report("read_into", payload_size, ops, counters);
+}
+
+
+static void bench_readline(size_t payload_size)
+{
+    bench::PtyPair pty;
+    serial::Serial port(pty.name, 115200, 5.0);
+    port.open();
+    
+    bench::Peer peer(pty.master_fd, bench::Peer::Mode::FEED, line_pattern(payload_size));
+    std::vector<char> buffer(payload_size);
+    size_t ops = op_count(payload_size);
+    Counters counters;
+    
+    for(size_t i = 0; i < ops; i++)
+        port.readline();
+    
+    report("readline", payload_size, ops, counters);
+    
+    counters = Counters();
+    
+    for(size_t i = 0; i < ops; i++)
+        port.readline_into(buffer);
+    
+    report("readline_into", payload_size, ops, counters);
+    
+    std::vector<std::string_view> lines;
+    size_t num = 0;
+    counters = Counters();
+    
+    while(num < ops)                                                                        // a burst of lines per call
+    {
+        port.try_readlines(lines);
+        num += lines.size();
+    }
+    
+    report("readlines", payload_size, num, counters);
+}
+
+
+static void bench_round_trip(size_t payload_size)
+{
+    bench::PtyPair pty;
+    serial::Serial port(pty.name, 115200, 5.0);
+    port.open();
+    
+    bench::Peer peer(pty.master_fd, bench::Peer::Mode::LOOPBACK);
+    std::vector<uint8_t> request(payload_size, 0x55);
+    std::vector<uint8_t> response(payload_size);
+    std::vector<double> samples;
+    samples.reserve(BENCH_ROUND_TRIPS);
+    Counters counters;
+    
+    for(int i = 0; i < BENCH_ROUND_TRIPS; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        port.write(request);
+        port.read_into(response);
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        samples.push_back(elapsed.count());
+    }
+    
+    uint64_t syscalls = syscall_count - counters.syscalls;
+    uint64_t allocations = allocation_count - counters.allocations;
+    
+    bench::Record("round_trip").add("payload", payload_size).add("ops", BENCH_ROUND_TRIPS)
+                               .add("p50_us", bench::percentile(samples, 0.50))
+                               .add("p90_us", bench::percentile(samples, 0.90))
+                               .add("p99_us", bench::percentile(samples, 0.99))
+                               .add("p999_us", bench::percentile(samples, 0.999))
+                               .add("max_us", samples.back())
+                               .add("syscalls_per_op", (double)syscalls / BENCH_ROUND_TRIPS)
+                               .add("allocs_per_op", (double)allocations / BENCH_ROUND_TRIPS)
+                               .print();
+}
+
+
+int main(void)
+{
+    for(size_t payload_size : {1, 16, 64, 256, 1024, 4096})
+    {
+        bench_write(payload_size);
+        bench_read(payload_size);
+        bench_readline(payload_size);
+        bench_round_trip(payload_size);
+    }
+    
+    return 0;
+}
+
+
+
@@ -0,0 +1,202 @@
+/**
+ * @file bench_serial_group.cpp
+ * @brief Serial group scaling benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Receives lines on N pty pairs, once with one blocking thread per port and
+ * once with a SerialGroup on one thread and on a small worker pool.
+ */
+
+
+#include "serial.hpp"
+#include "serial_group.hpp"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#include <pty.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+
+#define BENCH_LINES_PER_PORT                    2000
+#define BENCH_LINE                              "0123456789abcdef0123456789abcde\n"
+
+
+struct PtyPort
+{
+    int master_fd;
+    int slave_fd;
+    std::unique_ptr<serial::Serial> serial;
+};
+
+
+static std::vector<PtyPort> open_ports(size_t num)
+{
+    std::vector<PtyPort> ports(num);
+    
+    for(size_t i = 0; i < num; i++)
+    {
+        char name[64];
+        
+        if(openpty(&ports[i].master_fd, &ports[i].slave_fd, name, NULL, NULL) != 0)
+            throw std::runtime_error("openpty failed");
+        
+        ports[i].serial = std::make_unique<serial::Serial>(name, 115200, 5.0);
+        ports[i].serial->open();
+    }
+    
+    return ports;
+}
+
+
+static void close_ports(std::vector<PtyPort>& ports)
+{
+    for(size_t i = 0; i < ports.size(); i++)
+    {
+        ports[i].serial.reset();
+        ::close(ports[i].slave_fd);
+        ::close(ports[i].master_fd);
+    }
+}
+
+
+static void write_lines(std::vector<PtyPort>& ports)
+{
+    size_t length = std::strlen(BENCH_LINE);
+    
+    for(int line = 0; line < BENCH_LINES_PER_PORT; line++)
+    {
+        for(size_t i = 0; i < ports.size(); i++)
+        {
+            if(::write(ports[i].master_fd, BENCH_LINE, length) != (ssize_t)length)
+                throw std::runtime_error("write failed");
+        }
+    }
+}
+
+
+static long context_switches(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+
+static void report(const char* mode, size_t ports, std::chrono::steady_clock::time_point start, long switches)
+{
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double lines = (double)ports * BENCH_LINES_PER_PORT;
+    
+    std::cout << std::setw(5) << ports << "  " << std::left << std::setw(16) << mode << std::right << std::fixed
+              << std::setprecision(3) << std::setw(9) << elapsed.count() << " s" << std::setprecision(0)
+              << std::setw(12) << lines / elapsed.count() << " lines/s" << std::setw(10)
+              << context_switches() - switches << " ctx switches" << std::endl;
+}
+
+
+static void bench_threads(size_t num)
+{
+    std::vector<PtyPort> ports = open_ports(num);
+    std::vector<std::thread> readers;
+    long switches = context_switches();
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < num; i++)
+    {
+        serial::Serial* port = ports[i].serial.get();
+        readers.push_back(std::thread([port]() {
+            for(int line = 0; line < BENCH_LINES_PER_PORT; line++)
+                port->readline();
+        }));
+    }
+    
+    write_lines(ports);
+    
+    for(size_t i = 0; i < readers.size(); i++)
+        readers[i].join();
+    
+    report("thread per port", num, start, switches);
+    close_ports(ports);
+}
+
+
+static void bench_group(size_t num, unsigned workers)
+{
+    std::vector<PtyPort> ports = open_ports(num);
+    std::atomic<size_t> lines(0);
+    serial::SerialGroup group;
+    
+    for(size_t i = 0; i < num; i++)
+    {
+        group.add(*ports[i].serial, [&lines](serial::Serial& port) {
+            uint8_t buffer[4096];
+            size_t count = 0;
+            
+            while(port.in_waiting() > 0)                                                    // all data is buffered already, no syscalls
+            {
+                size_t size = port.read_into(buffer, std::min(port.in_waiting(), sizeof(buffer)));
+                
+                for(size_t j = 0; j < size; j++)
+                    count += (buffer[j] == '\n');
+            }
+            
+            lines += count;
+        });
+    }
+    
+    size_t expected = num * BENCH_LINES_PER_PORT;
+    long switches = context_switches();
+    auto start = std::chrono::steady_clock::now();
+    std::thread writer(write_lines, std::ref(ports));
+    
+    if(workers == 0)
+    {
+        while(lines < expected)
+            group.poll(1.0);
+    }
+    else
+    {
+        group.start(workers);
+        
+        while(lines < expected)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        
+        group.stop();
+    }
+    
+    writer.join();
+    
+    report((workers == 0) ? "group 1 thread" : "group 4 workers", num, start, switches);
+    close_ports(ports);
+}
+
+
+int main(void)
+{
+    std::cout << BENCH_LINES_PER_PORT << " lines of " << std::strlen(BENCH_LINE) << " bytes per port" << std::endl;
+    
+    const size_t port_counts[] = {1, 16, 64, 256};
+    
+    for(size_t num : port_counts)
+    {
+        bench_threads(num);
+        bench_group(num, 0);
+        bench_group(num, 4);
+    }
+    
+    return 0;
+}
+
+
+
@@ -0,0 +1,237 @@
+/**
+ * @file bench_transport.cpp
+ * @brief Transport benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Runs the same request/response and streaming workloads over a memory pair,
+ * a pty and a Unix domain socket. The ping-pong writes a line and waits for
+ * its echo, the stream reads lines fed by the peer as fast as possible. The
+ * memory pair shows the cost of the library itself, the difference to the
+ * other transports is the cost of the kernel.
+ */
+
+
+#include "serial.hpp"
+#include "transport.hpp"
+#include "bench.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+
+#define BENCH_ROUND_TRIPS                       20000
+#define BENCH_STREAM_LINES                      200000
+#define BENCH_LINE_SIZE                         64                                  // including the terminator
+#define BENCH_SOCKET_PATH                       "./bench/transport.sock"
+
+
+// peer on a Serial, for transports without a descriptor of the other end
+class SerialPeer
+{
+private:
+    std::thread thread;
+    std::atomic<bool> stop_flag;
+public:
+    SerialPeer(serial::Serial& port, bench::Peer::Mode mode, std::string pattern) : stop_flag(false)
+    {
+        this->thread = std::thread([this, &port, mode, pattern]() {
+            std::vector<uint8_t> buffer(65536);
+            
+            try
+            {
+                while(this->stop_flag == false)
+                {
+                    if(mode == bench::Peer::Mode::FEED)
+                    {
+                        port.write(pattern);
+                        continue;
+                    }
+                    
+                    size_t num = 0;
+                    
+                    if(port.try_read_some(buffer, num, std::chrono::milliseconds(50)) == serial::SerialStatus::OK)
+                        port.write(std::span<const uint8_t>(buffer.data(), num));
+                }
+            }
+            catch(const std::exception&)                                                    // the port is closed after the measurement
+            {
+            }
+        });
+    }
+    
+    SerialPeer(const SerialPeer&) = delete;
+    
+    ~SerialPeer(void)
+    {
+        this->stop_flag = true;
+        this->thread.join();
+    }
+};
+
+
+class TransportSetup
+{
+public:
+    serial::Serial port;
+    serial::Serial peer_port;
+    std::unique_ptr<bench::Peer> peer;
+    std::unique_ptr<SerialPeer> serial_peer;
+    int listen_fd;
+    int peer_fd;
+    
+    TransportSetup(const std::string& kind, bench::Peer::Mode mode, const std::string& pattern) : port("", 1000000, 5.0), peer_port("", 1000000, 5.0), listen_fd(-1), peer_fd(-1)
+    {
+        this->port.settle_policy(serial::SettlePolicy::NONE);
+        
+        if(kind == "memory")
+        {
+            auto pair = serial::MemoryTransport::pair();
+            this->port.transport(pair.first);
+            this->peer_port.transport(pair.second);
+            this->peer_port.settle_policy(serial::SettlePolicy::NONE);
+            this->peer_port.write_timeout(0.1);                                             // a blocked feed ends when the measurement is done
+            this->port.open();
+            this->peer_port.open();
+            this->serial_peer = std::make_unique<SerialPeer>(this->peer_port, mode, pattern);
+            return;
+        }
+        
+        if(kind == "pty")
+        {
+            auto pty = std::make_shared<serial::PtyTransport>();
+            this->port.transport(pty);
+            this->port.open();
+            this->peer = std::make_unique<bench::Peer>(pty->peer_fd(), mode, std::vector<uint8_t>(pattern.begin(), pattern.end()));
+            return;
+        }
+        
+        struct sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strcpy(address.sun_path, BENCH_SOCKET_PATH);
+        unlink(BENCH_SOCKET_PATH);
+        
+        this->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        
+        if(bind(this->listen_fd, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(this->listen_fd, 1) != 0)
+            throw std::runtime_error("socket listen failed");
+        
+        this->port.port(BENCH_SOCKET_PATH);
+        this->port.transport(std::make_shared<serial::UnixSocketTransport>());
+        this->port.open();
+        this->peer_fd = accept(this->listen_fd, NULL, NULL);
+        this->peer = std::make_unique<bench::Peer>(this->peer_fd, mode, std::vector<uint8_t>(pattern.begin(), pattern.end()));
+    }
+    
+    TransportSetup(const TransportSetup&) = delete;
+    
+    ~TransportSetup(void)
+    {
+        this->peer.reset();
+        this->serial_peer.reset();
+        
+        if(this->peer_port.is_open() == true)
+            this->peer_port.close();
+        
+        this->port.close();
+        
+        if(this->peer_fd >= 0)
+            ::close(this->peer_fd);
+        if(this->listen_fd >= 0)
+        {
+            ::close(this->listen_fd);
+            unlink(BENCH_SOCKET_PATH);
+        }
+    }
+};
+
+
+static std::string make_line(void)
+{
+    std::string line(BENCH_LINE_SIZE - 1, 'a');
+    return line + '\n';
+}
+
+
+static void bench_ping_pong(const std::string& kind)
+{
+    size_t round_trips = bench::iterations(BENCH_ROUND_TRIPS);
+    TransportSetup setup(kind, bench::Peer::Mode::LOOPBACK, "");
+    std::string line = make_line();
+    std::vector<double> samples;
+    samples.reserve(round_trips);
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < round_trips; i++)
+    {
+        auto request_start = std::chrono::steady_clock::now();
+        setup.port.write(line);
+        
+        if(setup.port.readline() != line)
+            throw std::runtime_error("echo mismatch");
+        
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - request_start).count());
+    }
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    bench::Record("transport_ping_pong").add("transport", kind).add("round_trips_per_s", round_trips / seconds)
+        .add("p50_us", bench::percentile(samples, 0.5)).add("p99_us", bench::percentile(samples, 0.99)).print();
+}
+
+
+static void bench_stream(const std::string& kind)
+{
+    size_t lines = bench::iterations(BENCH_STREAM_LINES);
+    std::string line = make_line();
+    TransportSetup setup(kind, bench::Peer::Mode::FEED, line);
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < lines; i++)
+    {
+        if(setup.port.readline() != line)
+            throw std::runtime_error("stream mismatch");
+    }
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    serial::SerialStats stats = setup.port.stats();
+    
+    bench::Record("transport_stream").add("transport", kind).add("lines_per_s", lines / seconds)
+        .add("mb_per_s", lines * BENCH_LINE_SIZE / seconds / 1e6).add("bytes_per_read", (double)stats.rx_bytes / stats.rx_syscalls).print();
+}
+
+
+int main(void)
+{
+    const char* kinds[] = {"memory", "pty", "unix"};
+    
+    try
+    {
+        for(const char* kind : kinds)
+        {
+            bench_ping_pong(kind);
+            bench_stream(kind);
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+
+
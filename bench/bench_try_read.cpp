@@ -0,0 +1,152 @@
+/**
+ * @file bench_try_read.cpp
+ * @brief Timeout-heavy polling benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Polls an idle pty port with a zero timeout, as done by polling loops which
+ * expect most reads to time out. Compares readline and read_into, which throw
+ * SerialTimeoutException, with try_readline and try_read_into, which return
+ * the timeout as status. A variant with one line per 100 polls checks that the
+ * status path also delivers the data.
+ */
+
+
+#include "serial.hpp"
+#include "bench.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+#include <unistd.h>
+
+
+#define BENCH_POLLS                             200000
+#define BENCH_LINE_INTERVAL                     100                                 // polls per received line in the mixed run
+#define BENCH_LINE                              "0123456789abcdef\n"
+
+
+static void report(const char* api, const char* load, std::chrono::steady_clock::time_point start, size_t polls, size_t lines)
+{
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    
+    bench::Record("timeout_poll").add("api", api).add("load", load).add("ns_per_poll", elapsed.count() / polls)
+        .add("lines", (double)lines).print();
+}
+
+
+static void feed(int master_fd, int poll)
+{
+    if(poll % BENCH_LINE_INTERVAL == 0 && ::write(master_fd, BENCH_LINE, sizeof(BENCH_LINE) - 1) < 0)
+        throw std::runtime_error("write failed");
+}
+
+
+static void bench_readline(serial::Serial& port, int master_fd, bool mixed)
+{
+    size_t polls = bench::iterations(BENCH_POLLS);
+    size_t lines = 0;
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < polls; i++)
+    {
+        if(mixed == true)
+            feed(master_fd, i);
+        
+        try
+        {
+            port.readline(std::chrono::nanoseconds(0));
+            lines++;
+        }
+        catch(const serial::SerialTimeoutException&)
+        {
+        }
+    }
+    
+    report("readline", (mixed == true) ? "mixed" : "idle", start, polls, lines);
+}
+
+
+static void bench_try_readline(serial::Serial& port, int master_fd, bool mixed)
+{
+    size_t polls = bench::iterations(BENCH_POLLS);
+    std::string line;
+    size_t lines = 0;
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < polls; i++)
+    {
+        if(mixed == true)
+            feed(master_fd, i);
+        
+        if(port.try_readline(line, std::chrono::nanoseconds(0)) == serial::SerialStatus::OK)
+            lines++;
+    }
+    
+    report("try_readline", (mixed == true) ? "mixed" : "idle", start, polls, lines);
+}
+
+
+static void bench_read_into(serial::Serial& port)
+{
+    size_t polls = bench::iterations(BENCH_POLLS);
+    uint8_t buffer[16];
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < polls; i++)
+    {
+        try
+        {
+            port.read_into(buffer, std::chrono::nanoseconds(0));
+        }
+        catch(const serial::SerialTimeoutException&)
+        {
+        }
+    }
+    
+    report("read_into", "idle", start, polls, 0);
+}
+
+
+static void bench_try_read_into(serial::Serial& port)
+{
+    size_t polls = bench::iterations(BENCH_POLLS);
+    uint8_t buffer[16];
+    size_t num;
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < polls; i++)
+        port.try_read_into(buffer, num, std::chrono::nanoseconds(0));
+    
+    report("try_read_into", "idle", start, polls, 0);
+}
+
+
+int main(void)
+{
+    try
+    {
+        bench::PtyPair pty;
+        serial::Serial port(pty.name, 115200, 1.0);
+        port.open();
+        
+        bench_readline(port, pty.master_fd, false);
+        bench_try_readline(port, pty.master_fd, false);
+        bench_read_into(port);
+        bench_try_read_into(port);
+        bench_readline(port, pty.master_fd, true);
+        bench_try_readline(port, pty.master_fd, true);
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+
+
@@ -0,0 +1,167 @@
+/**
+ * @file bench_tx_contention.cpp
+ * @brief Concurrent writer benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * 1 to 16 threads write fixed-size lines to one pty port, while one reader
+ * thread reads the lines looped back by the master side at the same time.
+ * Every line carries the thread and a sequence number, so the reader detects
+ * lines which were interleaved with others, lost or reordered. The writes go
+ * through the transmit queue directly and, for comparison, serialized by a
+ * mutex, with which every write takes its own system call.
+ */
+
+
+#include "serial.hpp"
+#include "bench.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+
+
+#define BENCH_MESSAGES                          40000                               // lines per run, divided between the threads
+#define BENCH_LINE_SIZE                         48                                  // including the terminator
+
+
+static std::string make_line(unsigned thread, unsigned sequence)
+{
+    char buffer[BENCH_LINE_SIZE + 1];
+    int num = snprintf(buffer, sizeof(buffer), "%02u %08u ", thread, sequence);
+    char fill = 'a' + (thread + sequence) % 26;
+    
+    for(int i = num; i < BENCH_LINE_SIZE - 1; i++)
+        buffer[i] = fill;
+    buffer[BENCH_LINE_SIZE - 1] = '\n';
+    
+    return std::string(buffer, BENCH_LINE_SIZE);
+}
+
+
+static bool check_line(const std::string& line, std::vector<unsigned>& expected)
+{
+    unsigned thread;
+    unsigned sequence;
+    
+    if(line.size() != BENCH_LINE_SIZE || sscanf(line.c_str(), "%02u %08u ", &thread, &sequence) != 2 || thread >= expected.size())
+        return false;
+    if(sequence != expected[thread])                                                        // lines of one thread arrive in order
+        return false;
+    
+    expected[thread]++;
+    return line == make_line(thread, sequence);
+}
+
+
+static void bench_writers(unsigned threads, bool locked)
+{
+    bench::PtyPair pty;
+    bench::Peer peer(pty.master_fd, bench::Peer::Mode::LOOPBACK);
+    serial::Serial port(pty.name, 115200, 5.0);
+    port.settle_policy(serial::SettlePolicy::NONE);
+    port.open();
+    
+    unsigned per_thread = std::max<size_t>(bench::iterations(BENCH_MESSAGES) / threads, 1);
+    std::vector<unsigned> expected(threads, 0);
+    size_t corrupted = 0;
+    size_t received = 0;
+    
+    std::thread reader([&]() {                                                              // full duplex: reads while the other threads write
+        try
+        {
+            while(received < (size_t)per_thread * threads)
+            {
+                if(check_line(port.readline(), expected) == false)
+                    corrupted++;
+                received++;
+            }
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << "reader: " << e.what() << std::endl;
+        }
+    });
+    
+    std::mutex write_mutex;
+    std::vector<std::vector<double>> latencies(threads);
+    std::vector<std::thread> writers;
+    auto start = std::chrono::steady_clock::now();
+    
+    for(unsigned t = 0; t < threads; t++)
+    {
+        writers.emplace_back([&, t]() {
+            latencies[t].reserve(per_thread);
+            
+            for(unsigned i = 0; i < per_thread; i++)
+            {
+                std::string line = make_line(t, i);
+                auto write_start = std::chrono::steady_clock::now();
+                
+                if(locked == true)
+                {
+                    std::lock_guard<std::mutex> lock(write_mutex);
+                    port.write(line);
+                }
+                else
+                {
+                    port.write(line);
+                }
+                
+                latencies[t].push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - write_start).count());
+            }
+        });
+    }
+    
+    for(std::thread& writer : writers)
+        writer.join();
+    
+    double write_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    reader.join();
+    
+    std::vector<double> samples;
+    
+    for(std::vector<double>& thread_samples : latencies)
+        samples.insert(samples.end(), thread_samples.begin(), thread_samples.end());
+    
+    serial::SerialStats stats = port.stats();
+    size_t total = (size_t)per_thread * threads;
+    
+    bench::Record("tx_contention").add("mode", (locked == true) ? "mutex" : "queue").add("threads", (double)threads)
+        .add("msg_per_s", total / write_s).add("p50_us", bench::percentile(samples, 0.5)).add("p99_us", bench::percentile(samples, 0.99))
+        .add("msg_per_syscall", (double)total / stats.tx_syscalls).add("received", (double)received).add("corrupted", (double)corrupted).print();
+    
+    port.close();
+    
+    if(corrupted > 0 || received != total)                                                  // interleaved, reordered or lost lines
+        throw std::runtime_error("tx_contention: lines corrupted or lost");
+}
+
+
+int main(void)
+{
+    const unsigned thread_counts[] = {1, 2, 4, 8, 16};
+    
+    try
+    {
+        for(unsigned threads : thread_counts)
+        {
+            bench_writers(threads, false);
+            bench_writers(threads, true);
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+
+
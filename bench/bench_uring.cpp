@@ -0,0 +1,125 @@
+/**
+ * @file bench_uring.cpp
+ * @brief I/O backend benchmark
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Compares the POSIX and the io_uring backend on pty pairs: round trips of
+ * write and read_into, and readline on a continuous stream of lines. The
+ * system calls are taken from the statistics of the port, which count the
+ * io_uring_enter calls as well.
+ */
+
+
+#include "serial.hpp"
+#include "uring.hpp"
+#include "bench.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+
+#define BENCH_ROUND_TRIPS                       5000
+#define BENCH_LINES                             50000
+#define BENCH_LINE                              "0123456789abcdef0123456789abcde\n"
+
+
+static const char* backend_name(serial::Backend backend)
+{
+    return (backend == serial::Backend::IO_URING) ? "io_uring" : "posix";
+}
+
+
+static void bench_round_trip(serial::Backend backend, size_t payload_size)
+{
+    size_t round_trips = bench::iterations(BENCH_ROUND_TRIPS);
+    bench::PtyPair pty;
+    serial::Serial port(pty.name, 115200, 5.0);
+    port.backend(backend);
+    port.open();
+    
+    bench::Peer peer(pty.master_fd, bench::Peer::Mode::LOOPBACK);
+    std::vector<uint8_t> payload(payload_size, 0x55);
+    std::vector<uint8_t> response(payload_size);
+    std::vector<double> samples;
+    samples.reserve(round_trips);
+    
+    port.reset_stats();
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < round_trips; i++)
+    {
+        auto sent = std::chrono::steady_clock::now();
+        port.write(payload);
+        port.read_into(response);
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent).count());
+    }
+    
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    serial::SerialStats stats = port.stats();
+    
+    bench::Record("uring_round_trip").add("backend", backend_name(port.backend())).add("payload", (double)payload_size)
+        .add("ops_per_s", round_trips / elapsed.count())
+        .add("syscalls_per_op", (double)(stats.rx_syscalls + stats.tx_syscalls) / round_trips)
+        .add("p50_us", bench::percentile(samples, 0.5)).add("p99_us", bench::percentile(samples, 0.99)).print();
+}
+
+
+static void bench_readline(serial::Backend backend)
+{
+    size_t lines = bench::iterations(BENCH_LINES);
+    bench::PtyPair pty;
+    serial::Serial port(pty.name, 115200, 5.0);
+    port.backend(backend);
+    port.open();
+    
+    std::string line = BENCH_LINE;
+    bench::Peer peer(pty.master_fd, bench::Peer::Mode::FEED, std::vector<uint8_t>(line.begin(), line.end()));
+    port.readline();                                                                        // the first line may be incomplete
+    
+    port.reset_stats();
+    auto start = std::chrono::steady_clock::now();
+    
+    for(size_t i = 0; i < lines; i++)
+        port.readline();
+    
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    serial::SerialStats stats = port.stats();
+    
+    bench::Record("uring_readline").add("backend", backend_name(port.backend()))
+        .add("mb_per_s", (double)stats.rx_bytes / elapsed.count() / 1e6)
+        .add("bytes_per_syscall", (double)stats.rx_bytes / stats.rx_syscalls).print();
+}
+
+
+int main(void)
+{
+    const size_t payload_sizes[] = {1, 64, 1024};
+    const serial::Backend backends[] = {serial::Backend::POSIX, serial::Backend::IO_URING};
+    
+    if(serial::IoUring::supported() == false)
+        std::cerr << "io_uring is not available, the POSIX backend is used instead" << std::endl;
+    
+    try
+    {
+        for(serial::Backend backend : backends)
+        {
+            for(size_t payload_size : payload_sizes)
+                bench_round_trip(backend, payload_size);
+            
+            bench_readline(backend);
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+
+
@@ -0,0 +1,139 @@
+/**
+ * @file check_termios.cpp
+ * @brief Termios call check
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Counts the termios calls of the read functions on a pty pair and fails if
+ * a read loop makes any, since the line discipline is set up once on open.
+ * tcgetattr and tcsetattr are wrapped at link time (see Makefile), because
+ * the ioctl they issue inside glibc is not visible to a wrapped ioctl; the
+ * ioctl calls of the library itself are counted if they get or set the
+ * termios settings. The open must be counted, otherwise the wrappers are not
+ * linked and the check would pass without measuring anything.
+ */
+
+
+#include "serial.hpp"
+#include "bench.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdarg>
+#include <cstdint>
+
+#include <termios.h>
+#include <sys/ioctl.h>
+
+
+#define CHECK_READS                             10000
+#define CHECK_LINE_SIZE                         16
+
+
+static uint64_t termios_count = 0;
+
+
+/* counting wrappers, linked with -Wl,--wrap=<function> */
+
+extern "C"
+{
+    int __real_tcgetattr(int fd, struct ::termios* settings);
+    int __real_tcsetattr(int fd, int action, const struct ::termios* settings);
+    int __real_ioctl(int fd, unsigned long request, void* argument);
+    
+    int __wrap_tcgetattr(int fd, struct ::termios* settings)
+    {
+        termios_count++;
+        return __real_tcgetattr(fd, settings);
+    }
+    
+    int __wrap_tcsetattr(int fd, int action, const struct ::termios* settings)
+    {
+        termios_count++;
+        return __real_tcsetattr(fd, action, settings);
+    }
+    
+    int __wrap_ioctl(int fd, unsigned long request, ...)
+    {
+        va_list arguments;
+        va_start(arguments, request);
+        void* argument = va_arg(arguments, void*);
+        va_end(arguments);
+        
+        // TCGETS2 to TCSETSF2 by number, their definitions need termios2, which clashes with termios.h
+        if(request == TCGETS || request == TCSETS || request == TCSETSW || request == TCSETSF)
+            termios_count++;
+        else if(_IOC_TYPE(request) == 'T' && _IOC_NR(request) >= 0x2A && _IOC_NR(request) <= 0x2D)
+            termios_count++;
+        
+        return __real_ioctl(fd, request, argument);
+    }
+}
+
+
+static bool check(const char* name, uint64_t count)
+{
+    std::cout << name << ": " << count << " termios calls" << std::endl;
+    
+    return count == 0;
+}
+
+
+int main(void)
+{
+    bench::PtyPair pty;
+    std::vector<uint8_t> pattern(CHECK_LINE_SIZE, 'x');
+    pattern.back() = '\n';
+    bench::Peer peer(pty.master_fd, bench::Peer::Mode::FEED, pattern);
+    serial::Serial port(pty.name, 115200, 5.0);
+    port.settle_policy(serial::SettlePolicy::NONE);
+    
+    bool passed = true;
+    
+    try
+    {
+        port.open();
+        
+        if(termios_count == 0)
+        {
+            std::cout << "open: no termios calls counted, the wrappers are not linked" << std::endl;
+            return 1;
+        }
+        
+        std::vector<uint8_t> buffer(CHECK_LINE_SIZE);
+        uint64_t start = termios_count;
+        
+        for(size_t i = 0; i < CHECK_READS; i++)
+            port.read(CHECK_LINE_SIZE);
+        
+        passed &= check("read", termios_count - start);
+        start = termios_count;
+        
+        for(size_t i = 0; i < CHECK_READS; i++)
+            port.readline();
+        
+        passed &= check("readline", termios_count - start);
+        start = termios_count;
+        
+        for(size_t i = 0; i < CHECK_READS; i++)
+            port.read_into(buffer);
+        
+        passed &= check("read_into", termios_count - start);
+        start = termios_count;
+        
+        for(size_t i = 0; i < CHECK_READS; i++)
+            port.read_some(buffer);
+        
+        passed &= check("read_some", termios_count - start);
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    
+    return (passed == true) ? 0 : 1;
+}
+
+
+
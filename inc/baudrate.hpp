@@ -0,0 +1,31 @@
+/**
+ * @file baudrate.hpp
+ * @brief Baudrate configuration header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Sets arbitrary baudrates with the Linux termios2 interface and the BOTHER
+ * flag. This is kept in its own file, because the kernel definition of
+ * termios2 can not be included together with termios.h.
+ */
+
+
+#ifndef BAUDRATE_HPP
+#define BAUDRATE_HPP
+
+
+#include <cstdint>
+
+
+namespace serial
+{
+    // return false if the driver rejects the baudrate or applies a baudrate which deviates by more than 2 %,
+    // the previous baudrate is kept in this case
+    bool set_baudrate(int fd, uint32_t baudrate);
+    
+    // return the baudrate used by the driver or 0 if it can not be read
+    uint32_t get_baudrate(int fd);
+}
+
+
+#endif
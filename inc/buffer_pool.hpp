@@ -0,0 +1,88 @@
+/**
+ * @file buffer_pool.hpp
+ * @brief Buffer pool header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Pool of reference-counted receive buffers. Buffers are sorted into size
+ * classes of powers of two and go back to the free list of their class when
+ * the last reference is released, so a long-running receive path stops
+ * allocating once the pool holds enough buffers of the sizes in use. The
+ * memory is taken from a std::pmr::memory_resource, by default new/delete.
+ * Copies of a BufferPool share the same buffers, so one pool can serve many
+ * ports; it may be used from several threads.
+ */
+
+
+#ifndef BUFFER_POOL_HPP
+#define BUFFER_POOL_HPP
+
+
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace serial
+{
+    struct PoolBlock;
+    struct PoolState;
+    
+    
+    // shared handle of one buffer, the buffer goes back to the pool when the last handle is destroyed
+    class PooledBuffer
+    {
+    private:
+        PoolBlock* block;
+        
+        explicit PooledBuffer(PoolBlock* block);
+        
+        friend class BufferPool;
+    public:
+        PooledBuffer();
+        PooledBuffer(const PooledBuffer& other);
+        PooledBuffer(PooledBuffer&& other) noexcept;
+        PooledBuffer& operator= (const PooledBuffer& other);
+        PooledBuffer& operator= (PooledBuffer&& other) noexcept;
+        ~PooledBuffer();
+        
+        const uint8_t* data(void) const;
+        uint8_t* data(void);
+        size_t size(void) const;
+        size_t capacity(void) const;
+        bool empty(void) const;
+        std::span<const uint8_t> span(void) const;
+        std::string_view view(void) const;
+        
+        // size up to the capacity
+        void resize(size_t new_size);
+        void reset(void);
+        uint32_t use_count(void) const;
+    };
+    
+    
+    class BufferPool
+    {
+    private:
+        std::shared_ptr<PoolState> state;
+    public:
+        BufferPool();
+        explicit BufferPool(std::pmr::memory_resource* resource);
+        
+        // buffer with a capacity of at least min_capacity and a size of 0
+        PooledBuffer acquire(size_t min_capacity);
+        
+        // number of buffers taken from the memory resource, and of those waiting in the free lists
+        size_t allocations(void) const;
+        size_t cached(void) const;
+        
+        // return the cached buffers to the memory resource
+        void trim(void);
+    };
+}
+
+
+#endif
@@ -0,0 +1,46 @@
+/**
+ * @file byte_search.hpp
+ * @brief Byte search header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Search functions for delimiters in received data. Single bytes are searched
+ * memchr-like 16 or 32 bytes at a time, byte sequences with a filter on their
+ * first and last byte. The fastest kernel supported by the CPU is selected at
+ * runtime, a scalar kernel is used on other architectures.
+ */
+
+
+#ifndef BYTE_SEARCH_HPP
+#define BYTE_SEARCH_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace serial
+{
+    enum class SearchKernel
+    {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+    
+    
+    // kernel selected by CPU dispatch
+    SearchKernel search_kernel(void);
+    bool search_kernel_supported(SearchKernel kernel);
+    
+    // return a pointer to the first match or NULL if there is no match
+    const uint8_t* find_byte(const uint8_t* data, size_t size, uint8_t value);
+    const uint8_t* find_sequence(const uint8_t* data, size_t size, const uint8_t* pattern, size_t pattern_size);
+    
+    // same with an explicitly selected kernel, which must be supported by the CPU
+    const uint8_t* find_byte(SearchKernel kernel, const uint8_t* data, size_t size, uint8_t value);
+    const uint8_t* find_sequence(SearchKernel kernel, const uint8_t* data, size_t size, const uint8_t* pattern, size_t pattern_size);
+}
+
+
+#endif
@@ -0,0 +1,157 @@
+/**
+ * @file capture.hpp
+ * @brief Capture and replay header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Byte-accurate trace of the data which crosses a serial port. Every chunk
+ * read from or written to the port is stored as one record with a monotonic
+ * timestamp, its direction and a channel number in a preallocated ring file,
+ * which is mapped into memory. Writing a record reserves its space with one
+ * atomic addition and copies the data, so the receive and transmit paths
+ * record concurrently without locks or system calls; when the ring is full the
+ * oldest records are overwritten. The file survives a crash of the process
+ * and is read with a CaptureReader. A CaptureReplay plays the received data of
+ * a capture on a pty with the original or an accelerated timing, so a Serial
+ * opened on the pty returns the captured data through the usual functions.
+ */
+
+
+#ifndef CAPTURE_HPP
+#define CAPTURE_HPP
+
+
+#include <string>
+#include <vector>
+#include <span>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <sys/uio.h>
+
+
+#define CAPTURE_ALL_CHANNELS                    -1                                  // channel filter of a CaptureReplay
+
+
+namespace serial
+{
+    enum class CaptureDirection : uint8_t
+    {
+        RX,
+        TX
+    };
+    
+    
+    struct CaptureRecord
+    {
+        std::chrono::nanoseconds timestamp;             // steady clock
+        CaptureDirection direction;
+        uint16_t channel;
+        std::span<const uint8_t> data;                  // valid until the next call of the reader
+    };
+    
+    
+    struct CaptureState;
+    
+    
+    // copies share the same file, records may be written from several threads
+    class Capture
+    {
+    private:
+        std::shared_ptr<CaptureState> state;
+    public:
+        Capture();                                      // inactive, records nothing
+        
+        // create or truncate the file, the ring is rounded up to a power of two and allocated on disk and in memory
+        explicit Capture(const std::string& path, size_t capacity);
+        
+        bool active(void) const;
+        void record(CaptureDirection direction, uint16_t channel, std::span<const uint8_t> data);
+        void record(CaptureDirection direction, uint16_t channel, const struct iovec* iov, int count, size_t size);
+        
+        // write the mapped pages to the file, the kernel also does this on its own
+        void sync(void);
+        
+        std::string path(void) const;
+        size_t capacity(void) const;
+        uint64_t written(void) const;                   // bytes of all records including the overwritten ones
+        uint64_t dropped(void) const;                   // records larger than the ring
+    };
+    
+    
+    // reads the records of a capture file from the oldest to the newest
+    class CaptureReader
+    {
+    private:
+        int fd;
+        uint8_t* map;
+        size_t map_size;
+        const uint8_t* data;                            // ring of records
+        uint64_t mask;
+        uint64_t start;                                 // oldest position which is not overwritten
+        uint64_t end;                                   // position of the next record at the time the file was opened
+        uint64_t position;
+        uint64_t dropped_stored;
+        std::vector<uint8_t> wrap_buffer;               // data of a record which wraps around the end of the ring
+        
+        void copy(uint64_t position, void* buffer, size_t size);
+        bool valid(uint64_t position);
+    public:
+        explicit CaptureReader(const std::string& path);
+        CaptureReader(const CaptureReader&) = delete;
+        ~CaptureReader();
+        
+        // false after the newest record
+        bool next(CaptureRecord& record);
+        void rewind(void);
+        uint64_t dropped(void);
+    };
+    
+    
+    // plays the received data of a capture on a pty, which is opened by Serial like a port
+    class CaptureReplay
+    {
+    private:
+        CaptureReader reader;
+        int channel_stored;                             // replayed channel, CAPTURE_ALL_CHANNELS for all
+        float speed_stored;                             // 1.0 is the original timing, 0.0 as fast as possible
+        int master_fd;
+        int slave_fd;                                   // kept open, so the pty stays valid while the port is closed
+        int wake_fd;
+        std::string port_stored;
+        std::thread thread;
+        std::atomic<bool> finished_flag;
+        std::atomic<uint64_t> replayed_stored;
+        std::atomic<uint64_t> drained_stored;
+        
+        void replay_loop(void);
+        bool wait(short events, const struct timespec* timeout);
+    public:
+        explicit CaptureReplay(const std::string& path);
+        explicit CaptureReplay(const std::string& path, int channel);
+        CaptureReplay(const CaptureReplay&) = delete;
+        ~CaptureReplay();
+        
+        // name of the pty, open the Serial before the replay is started, since open flushes the input
+        std::string port(void);
+        
+        // the written data of the application is read and discarded, so its writes do not block
+        void start(void);
+        void stop(void);
+        bool running(void);
+        bool finished(void);
+        
+        float speed(void);
+        void speed(float new_speed);
+        
+        uint64_t replayed(void);                        // bytes played to the pty
+        uint64_t drained(void);                         // bytes written by the application
+    };
+}
+
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file crc.hpp
+ * @brief CRC header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * CRC-16/CCITT, CRC-16/MODBUS, CRC-32 and CRC-32C for generating and checking
+ * frames. The portable kernel processes 8 bytes per step with slicing-by-8
+ * tables. On x86 CRC-32 is folded with PCLMULQDQ and CRC-32C uses the SSE4.2
+ * crc32 instruction. The fastest kernel supported by the CPU is selected at
+ * runtime.
+ */
+
+
+#ifndef CRC_HPP
+#define CRC_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace serial
+{
+    enum class Crc
+    {
+        NONE,
+        CRC16_CCITT,                                    // polynomial 0x1021, init 0xFFFF, sent big-endian
+        CRC16_MODBUS,                                   // polynomial 0x8005 reflected, init 0xFFFF, sent little-endian
+        CRC32,                                          // Ethernet/zlib, polynomial 0x04C11DB7 reflected, sent little-endian
+        CRC32C                                          // Castagnoli, polynomial 0x1EDC6F41 reflected, sent little-endian
+    };
+    
+    enum class CrcKernel
+    {
+        TABLE,                                          // one byte per step
+        SLICING_BY_8,                                   // eight bytes per step
+        HARDWARE                                        // PCLMULQDQ for CRC-32, SSE4.2 for CRC-32C
+    };
+    
+    
+    // kernel selected by CPU dispatch
+    CrcKernel crc_kernel(Crc type);
+    bool crc_kernel_supported(Crc type, CrcKernel kernel);
+    
+    // number of bytes of the check value on the wire
+    size_t crc_size(Crc type);
+    
+    // return the check value of the data, 0 for Crc::NONE
+    uint32_t crc(Crc type, const uint8_t* data, size_t size);
+    
+    // same with an explicitly selected kernel, which must be supported by the CPU
+    uint32_t crc(Crc type, CrcKernel kernel, const uint8_t* data, size_t size);
+    
+    // store the check value in wire byte order, output must hold crc_size bytes
+    void crc_store(Crc type, uint32_t value, uint8_t* output);
+    
+    // check data followed by its check value in wire byte order
+    bool crc_check(Crc type, const uint8_t* data, size_t size);
+}
+
+
+#endif
+
+
+
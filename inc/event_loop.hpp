@@ -0,0 +1,319 @@
+/**
+ * @file event_loop.hpp
+ * @brief Event loop header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Single-threaded event loop for C++20 coroutines based on one epoll instance.
+ * Tasks are lazy coroutines, which are started with spawn or by co_await in
+ * another task. A task waiting for a file descriptor is suspended until the
+ * descriptor is ready, its deadline has passed or its wait is cancelled, so
+ * thousands of ports can be served with straight-line code in one thread.
+ * File descriptors are registered edge-triggered once; readiness reported while
+ * no task waits is remembered for the next wait.
+ */
+
+
+#ifndef EVENT_LOOP_HPP
+#define EVENT_LOOP_HPP
+
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <time.h>
+
+
+namespace serial
+{
+    typedef std::chrono::steady_clock::time_point Deadline;
+    
+    
+    // lazy coroutine, started when it is awaited or spawned on an event loop
+    template <typename T>
+    class Task
+    {
+    public:
+        struct promise_type
+        {
+            std::optional<T> value;
+            std::exception_ptr exception;
+            std::coroutine_handle<> continuation;
+            
+            Task get_return_object(void)
+            {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            
+            std::suspend_always initial_suspend(void) noexcept
+            {
+                return {};
+            }
+            
+            auto final_suspend(void) noexcept
+            {
+                struct FinalAwaiter
+                {
+                    bool await_ready(void) noexcept { return false; }
+                    void await_resume(void) noexcept {}
+                    
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+                    {
+                        std::coroutine_handle<> continuation = handle.promise().continuation;
+                        return continuation ? continuation : std::noop_coroutine();         // resume the awaiting task without recursion
+                    }
+                };
+                
+                return FinalAwaiter();
+            }
+            
+            template <typename U>
+            void return_value(U&& result)
+            {
+                this->value.emplace(std::forward<U>(result));
+            }
+            
+            void unhandled_exception(void)
+            {
+                this->exception = std::current_exception();
+            }
+        };
+        
+        explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+        Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+        Task(const Task&) = delete;
+        
+        ~Task()
+        {
+            if(this->handle)
+                this->handle.destroy();
+        }
+        
+        bool await_ready(void) noexcept
+        {
+            return false;
+        }
+        
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+        {
+            this->handle.promise().continuation = awaiting;
+            return this->handle;                                                            // start the task
+        }
+        
+        T await_resume(void)
+        {
+            if(this->handle.promise().exception)
+                std::rethrow_exception(this->handle.promise().exception);
+            
+            return std::move(*this->handle.promise().value);
+        }
+    private:
+        std::coroutine_handle<promise_type> handle;
+    };
+    
+    
+    template <>
+    class Task<void>
+    {
+    public:
+        struct promise_type
+        {
+            std::exception_ptr exception;
+            std::coroutine_handle<> continuation;
+            
+            Task get_return_object(void)
+            {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            
+            std::suspend_always initial_suspend(void) noexcept
+            {
+                return {};
+            }
+            
+            auto final_suspend(void) noexcept
+            {
+                struct FinalAwaiter
+                {
+                    bool await_ready(void) noexcept { return false; }
+                    void await_resume(void) noexcept {}
+                    
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+                    {
+                        std::coroutine_handle<> continuation = handle.promise().continuation;
+                        return continuation ? continuation : std::noop_coroutine();
+                    }
+                };
+                
+                return FinalAwaiter();
+            }
+            
+            void return_void(void) {}
+            
+            void unhandled_exception(void)
+            {
+                this->exception = std::current_exception();
+            }
+        };
+        
+        explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+        Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+        Task(const Task&) = delete;
+        
+        ~Task()
+        {
+            if(this->handle)
+                this->handle.destroy();
+        }
+        
+        bool await_ready(void) noexcept
+        {
+            return false;
+        }
+        
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+        {
+            this->handle.promise().continuation = awaiting;
+            return this->handle;
+        }
+        
+        void await_resume(void)
+        {
+            if(this->handle.promise().exception)
+                std::rethrow_exception(this->handle.promise().exception);
+        }
+    private:
+        std::coroutine_handle<promise_type> handle;
+    };
+    
+    
+    enum class WaitResult
+    {
+        READY,
+        TIMEOUT,
+        CANCELLED
+    };
+    
+    
+    class EventLoop;
+    
+    
+    // cancels the wait of the operation it is passed to, must be used in the thread running the loop
+    class Cancellation
+    {
+    private:
+        bool cancelled_flag;
+        EventLoop* loop;
+        void* waiter;                                   // pending wait, NULL if the operation is not suspended
+        
+        friend class EventLoop;
+    public:
+        Cancellation();
+        Cancellation(const Cancellation&) = delete;
+        
+        void cancel(void);
+        bool cancelled(void);
+        void reset(void);
+    };
+    
+    
+    class EventLoop
+    {
+    private:
+        struct Waiter
+        {
+            int fd;                                     // -1 for a pure timer
+            bool writable_flag;
+            Deadline deadline;
+            Cancellation* cancellation;
+            WaitResult result;
+            std::coroutine_handle<> handle;
+            std::multimap<Deadline, Waiter*>::iterator timer;
+            bool timer_flag;
+            bool suspended_flag;                        // registered in the loop until it is completed
+            bool queued_flag;                           // completed, the task waits in the ready queue
+        };
+        
+        struct FdState
+        {
+            int fd;
+            Waiter* reader;
+            Waiter* writer;
+            bool readable_flag;                         // edge reported while no task was waiting
+            bool writable_flag;
+        };
+        
+        int epoll_fd;
+        std::unordered_map<int, std::unique_ptr<FdState>> fds;
+        std::multimap<Deadline, Waiter*> timers;
+        std::deque<std::coroutine_handle<>> ready;
+        size_t active_tasks;
+        bool stop_flag;
+        std::exception_ptr task_exception;              // first exception which left a spawned task
+        
+        std::unordered_set<void*> detached_tasks;       // frames of spawned tasks, destroyed with the loop
+        std::shared_ptr<EventLoop*> self;               // set to NULL by the destructor
+        
+        FdState* state(int fd);
+        void suspend(Waiter* waiter, std::coroutine_handle<> handle);
+        void complete(Waiter* waiter, WaitResult result);
+        void detach(Waiter* waiter);
+        void process(const struct timespec* timeout);
+        
+        struct Detached;
+        static Detached run_detached(EventLoop* loop, Task<void> task);
+        
+        friend class Cancellation;
+    public:
+        class WaitOperation
+        {
+        private:
+            EventLoop* loop;
+            Waiter waiter;
+        public:
+            WaitOperation(EventLoop* loop, int fd, bool writable, Deadline deadline, Cancellation* cancellation);
+            ~WaitOperation();                           // a task destroyed while it waits leaves no waiter behind
+            
+            bool await_ready(void);
+            void await_suspend(std::coroutine_handle<> handle);
+            WaitResult await_resume(void);
+        };
+        
+        EventLoop();
+        EventLoop(const EventLoop&) = delete;
+        ~EventLoop();
+        
+        // start a task, which runs until it completes, exceptions are rethrown by run
+        void spawn(Task<void> task);
+        
+        // run until all spawned tasks are completed or stop is called
+        void run(void);
+        void stop(void);
+        size_t tasks(void);
+        
+        // awaitable waits, cancellation may be NULL, Deadline::max() means no deadline
+        WaitOperation readable(int fd, Deadline deadline, Cancellation* cancellation);
+        WaitOperation writable(int fd, Deadline deadline, Cancellation* cancellation);
+        WaitOperation sleep_until(Deadline deadline, Cancellation* cancellation);
+        
+        // forget a file descriptor before it is closed
+        void remove(int fd);
+        
+        // pointer to this loop, which becomes NULL when the loop is destroyed
+        std::shared_ptr<EventLoop*> reference(void);
+    };
+}
+
+
+#endif
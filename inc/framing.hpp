@@ -0,0 +1,97 @@
+/**
+ * @file framing.hpp
+ * @brief Frame stream header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Framing layer on top of Serial for COBS, SLIP and length-prefixed frames.
+ * Received frames are decoded in place in the receive buffer of the stream and
+ * returned as views, which stay valid until the next call of read_frame. After
+ * corrupt input the stream drops data until the next frame boundary. Frames
+ * are encoded into a reused buffer and written with one system call. With a
+ * CRC selected, the check value is appended to every written payload and
+ * received frames with a wrong check value are dropped before they are
+ * returned.
+ */
+
+
+#ifndef FRAMING_HPP
+#define FRAMING_HPP
+
+
+#include <vector>
+#include <span>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "serial.hpp"
+#include "rx_buffer.hpp"
+#include "crc.hpp"
+
+
+namespace serial
+{
+    enum class Framing
+    {
+        COBS,                                           // consistent overhead byte stuffing, frames end with 0x00
+        SLIP,                                           // RFC 1055, frames start and end with 0xC0
+        LENGTH_PREFIX                                   // 16 bit big-endian payload length before the payload
+    };
+    
+    
+    class FrameStream
+    {
+    private:
+        Serial& serial;
+        Framing framing_stored;
+        size_t max_frame_size_stored;                   // maximum payload size
+        RxBuffer rx_buffer;                             // received data, frames are decoded in place
+        size_t consumed;                                // size of the frame returned last, removed on the next call
+        bool discard_flag;                              // dropping data until the next frame boundary
+        uint64_t dropped_frames;
+        Crc crc_stored;
+        uint64_t crc_errors_stored;
+        std::vector<uint8_t> tx_buffer;                 // encoded frame, reused for every write
+        std::vector<uint8_t> crc_buffer;                // payload with check value before encoding
+        
+        size_t max_decoded_size(void);
+        
+        bool next_frame(std::span<const uint8_t>& frame);
+        bool next_delimited_frame(uint8_t delimiter, std::span<const uint8_t>& frame);
+        bool next_length_prefix_frame(std::span<const uint8_t>& frame);
+    public:
+        // with LENGTH_PREFIX the maximum frame size and the check value must fit into 16 bit
+        explicit FrameStream(Serial& serial, Framing framing);
+        explicit FrameStream(Serial& serial, Framing framing, size_t max_frame_size);
+        FrameStream(const FrameStream&) = delete;
+        
+        // return the payload of the next valid frame, valid until the next call
+        std::span<const uint8_t> read_frame(void);
+        std::span<const uint8_t> read_frame(std::chrono::nanoseconds timeout);
+        
+        // encode the payload and write it with one system call
+        void write_frame(std::span<const uint8_t> payload);
+        
+        Framing framing(void);
+        size_t max_frame_size(void);
+        uint64_t dropped(void);                         // corrupt or oversized frames
+        
+        // check value appended to each payload, Crc::NONE by default
+        Crc crc(void);
+        void crc(Crc type);
+        uint64_t crc_errors(void);                      // frames dropped because of a wrong check value
+    };
+    
+    
+    // decode in place, return the payload size or -1 if the frame is corrupt
+    long cobs_decode(uint8_t* data, size_t size);
+    long slip_decode(uint8_t* data, size_t size);
+    
+    // append the encoded frame including delimiters to the output
+    void cobs_encode(std::span<const uint8_t> payload, std::vector<uint8_t>& output);
+    void slip_encode(std::span<const uint8_t> payload, std::vector<uint8_t>& output);
+}
+
+
+#endif
@@ -0,0 +1,155 @@
+/**
+ * @file modbus.hpp
+ * @brief Modbus RTU master header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Modbus RTU master on top of Serial. Requests are sent with slave address and
+ * CRC-16/MODBUS. The end of a response is detected by its length, which
+ * follows from the function code, or by a silence of 3.5 characters, which is
+ * derived from the baudrate, so a transaction returns as soon as the response
+ * is complete instead of waiting for the read timeout. The next request on a
+ * bus is sent as soon as the inter-frame gap after the last frame has passed.
+ * A ModbusPoller polls many buses concurrently on one EventLoop; each bus has
+ * one outstanding request, as required by RTU.
+ */
+
+
+#ifndef MODBUS_HPP
+#define MODBUS_HPP
+
+
+#include <vector>
+#include <span>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "serial.hpp"
+#include "event_loop.hpp"
+
+
+#define MODBUS_ADU_SIZE                         256                                 // slave address, PDU and CRC
+#define MODBUS_PDU_SIZE                         253
+#define MODBUS_MAX_READ_REGISTERS               125
+#define MODBUS_MAX_WRITE_REGISTERS              123
+
+
+namespace serial
+{
+    enum class ModbusStatus
+    {
+        OK,
+        TIMEOUT,                                        // no response within the response timeout
+        CRC_ERROR,
+        EXCEPTION,                                      // the slave returned an exception code
+        INVALID_RESPONSE,                               // wrong slave, function or size
+        INVALID_ARGUMENT,
+        IO_ERROR
+    };
+    
+    
+    struct ModbusStats
+    {
+        uint64_t transactions;
+        uint64_t timeouts;
+        uint64_t crc_errors;
+        uint64_t exceptions;
+        uint64_t invalid_responses;
+        uint64_t gap_ends;                              // responses ended by the gap instead of their length
+    };
+    
+    
+    class ModbusMaster
+    {
+    private:
+        Serial& serial;
+        float response_timeout_stored;                  // in seconds
+        std::chrono::nanoseconds gap_stored;            // negative if derived from the baudrate
+        Deadline bus_idle;                              // end of the inter-frame gap after the last frame
+        bool resync_flag;                               // discard stale input before the next request
+        uint8_t exception_code_stored;
+        ModbusStats stats_stored;
+        std::array<uint8_t, MODBUS_ADU_SIZE> tx_frame;
+        std::array<uint8_t, MODBUS_ADU_SIZE> rx_frame;
+        size_t tx_size;
+        size_t rx_size;
+        
+        ModbusStatus prepare(uint8_t slave, std::span<const uint8_t> request);
+        bool received(size_t num, Deadline& last_received);
+        ModbusStatus finish(ModbusStatus status, Deadline last_received, std::span<uint8_t> response, size_t& response_size);
+        ModbusStatus check(std::span<uint8_t> response, size_t& response_size);
+    public:
+        explicit ModbusMaster(Serial& serial);
+        ModbusMaster(const ModbusMaster&) = delete;
+        
+        // send a request PDU, function code and data, and return the response PDU, no response is expected from slave 0
+        ModbusStatus transact(uint8_t slave, std::span<const uint8_t> request, std::span<uint8_t> response, size_t& response_size);
+        Task<ModbusStatus> async_transact(EventLoop& loop, uint8_t slave, std::span<const uint8_t> request, std::span<uint8_t> response, size_t& response_size);
+        
+        // function codes 0x03, 0x04, 0x06 and 0x10, the size of the span is the number of registers
+        ModbusStatus read_holding_registers(uint8_t slave, uint16_t address, std::span<uint16_t> registers);
+        ModbusStatus read_input_registers(uint8_t slave, uint16_t address, std::span<uint16_t> registers);
+        ModbusStatus write_register(uint8_t slave, uint16_t address, uint16_t value);
+        ModbusStatus write_registers(uint8_t slave, uint16_t address, std::span<const uint16_t> registers);
+        Task<ModbusStatus> async_read_registers(EventLoop& loop, uint8_t slave, uint8_t function, uint16_t address, std::span<uint16_t> registers);
+        
+        // exception code of the last transaction which returned ModbusStatus::EXCEPTION
+        uint8_t exception_code(void);
+        
+        float response_timeout(void);
+        void response_timeout(float new_timeout);
+        
+        // 3.5 character times, derived from the baudrate of the port unless set, a negative value restores the default
+        std::chrono::nanoseconds gap(void);
+        void gap(std::chrono::nanoseconds new_gap);
+        
+        ModbusStats stats(void);
+        Serial& port(void);
+    };
+    
+    
+    struct ModbusPoll
+    {
+        ModbusMaster* master;
+        uint8_t slave;
+        uint8_t function;                               // 0x03 or 0x04
+        uint16_t address;
+        std::vector<uint16_t> registers;                // values of the last successful poll, one entry per register
+        ModbusStatus status;                            // result of the last poll
+    };
+    
+    
+    class ModbusPoller
+    {
+    private:
+        EventLoop loop;
+        std::vector<ModbusPoll> polls;
+        std::vector<ModbusMaster*> buses;
+        std::vector<std::vector<size_t>> bus_polls;     // indices of the polls of each bus in the order they were added
+        
+        Task<void> poll_bus(size_t bus);
+    public:
+        ModbusPoller();
+        ModbusPoller(const ModbusPoller&) = delete;
+        
+        // add a register range, returns the index of the poll
+        size_t add(ModbusMaster& master, uint8_t slave, uint8_t function, uint16_t address, uint16_t count);
+        ModbusPoll& poll(size_t index);
+        size_t size(void);
+        
+        // poll every range once, the buses concurrently and the ranges of one bus one after the other, returns the successful polls
+        size_t run_cycle(void);
+    };
+    
+    
+    // 3.5 character times of 10 bits, the 8N1 format of Serial, and 1.75 ms above 19200 Bd as the specification recommends
+    std::chrono::nanoseconds modbus_gap(uint32_t baudrate);
+    
+    // size of the complete response ADU, 0 as long as it is not known, e.g. for unknown function codes
+    size_t modbus_response_size(const uint8_t* response, size_t size);
+}
+
+
+#endif
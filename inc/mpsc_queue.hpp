@@ -0,0 +1,71 @@
+/**
+ * @file mpsc_queue.hpp
+ * @brief Multi-producer/single-consumer queue header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Lock-free intrusive queue for any number of producer threads and one consumer.
+ * A producer pushes a node with one compare-and-swap, the consumer takes all
+ * pushed nodes at once with one exchange and gets them in push order. The nodes
+ * are owned by the producers, so pushing never allocates, and since the consumer
+ * never removes single nodes, there is no ABA problem.
+ */
+
+
+#ifndef MPSC_QUEUE_HPP
+#define MPSC_QUEUE_HPP
+
+
+#include <atomic>
+
+
+namespace serial
+{
+    // T needs a member T* next, which is used by the queue while the node is pushed
+    template <typename T>
+    class MpscQueue
+    {
+    private:
+        std::atomic<T*> head;                           // last pushed node, linked to the earlier ones
+    public:
+        MpscQueue() : head(NULL) {}
+        MpscQueue(const MpscQueue&) = delete;
+        
+        // producer side
+        void push(T* node)
+        {
+            T* expected = this->head.load(std::memory_order_relaxed);
+            
+            do
+            {
+                node->next = expected;
+            }
+            while(this->head.compare_exchange_weak(expected, node, std::memory_order_seq_cst, std::memory_order_relaxed) == false);
+        }
+        
+        // consumer side, returns the first pushed node linked to the later ones, NULL if the queue is empty
+        T* take_all(void)
+        {
+            T* node = this->head.exchange(NULL, std::memory_order_seq_cst);
+            T* first = NULL;
+            
+            while(node != NULL)                                                             // reverse the list into push order
+            {
+                T* next = node->next;
+                node->next = first;
+                first = node;
+                node = next;
+            }
+            
+            return first;
+        }
+        
+        bool empty(void) const
+        {
+            return this->head.load(std::memory_order_seq_cst) == NULL;
+        }
+    };
+}
+
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * @file rx_buffer.hpp
+ * @brief Receive buffer header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Byte ring buffer for received data. The readable bytes are always kept in
+ * one contiguous block: instead of wrapping around, the remaining bytes are
+ * moved to the front when the write position reaches the end of the storage.
+ * When the buffer runs empty both positions restart at zero without a copy.
+ */
+
+
+#ifndef RX_BUFFER_HPP
+#define RX_BUFFER_HPP
+
+
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace serial
+{
+    class RxBuffer
+    {
+    private:
+        std::vector<uint8_t> storage;
+        size_t head;                                    // position of the first readable byte
+        size_t tail;                                    // position of the first free byte
+    public:
+        explicit RxBuffer(size_t capacity);
+        
+        // readable data
+        const uint8_t* data(void) const;
+        uint8_t* data(void);
+        size_t size(void) const;
+        bool empty(void) const;
+        void consume(size_t size);
+        size_t read(uint8_t* buffer, size_t size);
+        void clear(void);
+        
+        // free space for new data, grows the storage if necessary
+        std::span<uint8_t> prepare(size_t min_size);
+        void commit(size_t size);
+        
+        size_t capacity(void) const;
+    };
+}
+
+
+#endif
@@ -16,9 +16,30 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <span>
+#include <string_view>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <cstddef>
 #include <cstdint>
 #include <stdexcept>
 
+#include <sys/uio.h>
+
+#include "rx_buffer.hpp"
+#include "spsc_ring.hpp"
+#include "mpsc_queue.hpp"
+#include "serial_stats.hpp"
+#include "event_loop.hpp"
+#include "uring.hpp"
+#include "buffer_pool.hpp"
+#include "capture.hpp"
+#include "transport.hpp"
+
 
 namespace serial
 {
@@ -36,14 +57,167 @@ namespace serial
     };
     
     
+    class SerialCancelledException : public std::runtime_error
+    {
+    public:
+        explicit SerialCancelledException(const std::string& msg) : std::runtime_error(msg) {}
+    };
+    
+    
+    struct LowLatencyStatus
+    {
+        bool async_low_latency;                         // ASYNC_LOW_LATENCY flag of the driver
+        int latency_timer;                              // latency timer of the USB adapter in ms, -1 if not available
+        int serial_error;                               // errno of a failed TIOCSSERIAL, e.g. EPERM, 0 otherwise
+    };
+    
+    
+    enum class SerialStatus
+    {
+        OK,
+        TIMEOUT,                                        // received data stays buffered for the next call
+        CLOSED,
+        CALLBACK,                                       // received data is delivered by a callback
+        INVALID_ARGUMENT,
+        IO_ERROR                                        // errno describes the error
+    };
+    
+    
+    enum class Backend
+    {
+        POSIX,                                          // poll and read or write system calls
+        IO_URING                                        // poll linked to the transfer, submitted with one system call
+    };
+    
+    
+    enum class SettlePolicy
+    {
+        FIXED,                                          // wait the settle time after the settings are applied, then flush
+        QUIET,                                          // flush and discard received data until the line is quiet for the settle time
+        NONE                                            // flush immediately, e.g. for pty or USB CDC ports
+    };
+    
+    
+    class Serial;
+    
+    
+    struct OpenResult
+    {
+        Serial* serial;
+        bool success;
+        std::string error;                              // message of the exception, which open would have thrown
+    };
+    
+    
+    typedef std::function<void(std::span<const uint8_t>)> ChunkCallback;
+    typedef std::function<void(std::string_view)> LineCallback;
+    
+    
     class Serial
     {
     private:
+        struct TxMessage
+        {
+            const struct iovec* iov;                    // buffers of the writing thread
+            int count;
+            bool queued;                                // appended to the queued data instead of sent
+            Deadline deadline;                          // each message waits for the port until its own deadline
+            size_t sent;                                // Bytes written, a started message is finished before the next one
+            std::exception_ptr error;
+            std::atomic<uint32_t> state;                // futex word, pending until the message is written
+            int notify_fd;                              // eventfd of an async write, -1 if the thread waits on the futex
+            TxMessage* next;
+        };
+        
+        struct TxAsyncMessage : TxMessage               // copy of an async write, shared by its task and the writing threads
+        {
+            std::vector<uint8_t> data;
+            struct iovec buffer;
+            std::atomic<int> references;
+            std::atomic<bool> driving;                  // the task waits until the port is writable and sends the queue
+            std::atomic<bool> abandoned;                // the task is gone, the rest of the message is dropped
+            
+            void release(void);                         // the last of the task and the queue frees the message
+        };
+        
         std::string port_stored;
         uint32_t baudrate_stored;
         float timeout_stored;                           // read timeout in seconds
+        float write_timeout_stored;                     // write timeout in seconds
+        float inter_byte_timeout_stored;                // maximum gap between received bytes in seconds
+        std::string terminator_stored;                  // line terminator for readline
         bool open_flag;
-        int serial_fd;
+        int serial_fd;                                  // descriptor of the transport for poll, epoll and io_uring
+        std::shared_ptr<Transport> transport_stored;
+        RxBuffer rx_buffer;                             // received but not yet returned data
+        std::vector<uint8_t> tx_buffer;                 // queued data, sent with one write call
+        size_t tx_threshold_stored;
+        BufferPool buffer_pool_stored;                  // buffers returned by the pooled reads
+        Capture capture_stored;                         // trace of the transferred data, inactive by default
+        uint16_t capture_channel;
+        
+        std::unique_ptr<SpscRing> reader_ring;          // filled by the reader thread, empty if no reader is running
+        std::thread reader_thread;
+        std::thread dispatch_thread;                    // calls the callbacks, so slow callbacks do not stall the reader
+        std::atomic<bool> reader_error;
+        bool reader_callback_flag;
+        int reader_wake_fd;
+        StatsRecorder stats_recorder;
+        Backend backend_stored;
+        SettlePolicy settle_policy_stored;
+        float settle_time_stored;                       // in seconds
+        Deadline configured_time;                       // end of the settings of the last open
+        float busy_poll_stored;                         // spin budget of the receive waits in seconds, 0 blocks immediately
+        int busy_poll_cpu_stored;                       // CPU of the polling threads, -1 if not pinned
+        int busy_poll_priority_stored;                  // SCHED_FIFO priority of the polling threads, 0 keeps the scheduling class
+        bool low_latency_saved;                         // driver settings before low_latency(true), restored by low_latency(false)
+        bool async_low_latency_saved;
+        int latency_timer_saved;                        // -1 if the adapter has no latency timer
+        MpscQueue<TxMessage> tx_queue;                  // messages of the writing threads
+        std::atomic<bool> tx_active;                    // a writing thread drains tx_queue
+        TxMessage* tx_pending;                          // taken from tx_queue and not yet sent, owned by the holder of tx_active
+        TxMessage* tx_pending_last;
+        TxAsyncMessage* tx_driver;                      // async write whose task waits until the port is writable, NULL if none
+        std::atomic<bool> tx_reschedule;                // a task stopped waiting for the port, the next holder of tx_active picks another
+        std::unique_ptr<IoUring> uring;                 // receive path, NULL if the POSIX backend is used
+        std::unique_ptr<IoUring> tx_uring;              // transmit path, a ring must not be used by two threads
+        std::shared_ptr<EventLoop*> event_loop;         // loop of the async operations, the port is removed from it on close
+        
+        void configure(void);
+        void settle(void);
+        void abort_open(void);
+        ssize_t read_port(uint8_t* buffer, size_t size);
+        ssize_t spin_read(uint8_t* buffer, size_t size, Deadline deadline);
+        SerialStatus wait_port(short events, Deadline deadline);
+        ssize_t uring_transfer(short events, struct iovec* iov, int count, Deadline deadline);
+        void cancel_uring(IoUring* ring, unsigned pending);
+        void transmit(TxMessage& message);
+        void collect_tx(void);
+        bool send_pending(bool blocking, std::atomic<uint32_t>** waiting, int& count);
+        void consume_tx(size_t num, std::atomic<uint32_t>** waiting, int& count);
+        void complete_tx(std::exception_ptr error, std::atomic<uint32_t>** waiting, int& count);
+        void fail_pending(std::exception_ptr error, std::atomic<uint32_t>** waiting, int& count);
+        bool release_tx(TxAsyncMessage* own, std::atomic<uint32_t>** waiting, int count);
+        void pick_driver(TxAsyncMessage* own);
+        void poll_tx(TxAsyncMessage* own);
+        TxAsyncMessage* start_async_tx(std::span<const uint8_t> data, Deadline deadline);
+        TxAsyncMessage* copy_tx(std::span<const uint8_t> data, Deadline deadline, size_t sent);
+        void resume_async_tx(TxAsyncMessage* message);
+        void abandon_async_tx(TxAsyncMessage* message);
+        SerialStatus wait_ring(Deadline deadline);
+        SerialStatus fill(Deadline deadline);
+        Deadline gap_deadline(Deadline deadline, Deadline last_received, bool received);
+        SerialStatus wait_until(const std::string& expected, size_t max_size, Deadline deadline, size_t& num);
+        SerialStatus drain(size_t& num);
+        void launch_reader(void);
+        void reader_loop(void);
+        void dispatch_chunks(ChunkCallback callback);
+        void dispatch_lines(LineCallback callback);
+        void attach(EventLoop& loop, bool receiving, const char* function);
+        Task<std::vector<uint8_t>> read_async(EventLoop& loop, uint32_t size, Deadline deadline, Cancellation* cancellation);
+        Task<std::string> readline_async(EventLoop& loop, Deadline deadline, Cancellation* cancellation);
+        Task<size_t> write_async(EventLoop& loop, std::span<const uint8_t> data, Deadline deadline, Cancellation* cancellation);
+        Task<SerialStatus> read_some_async(EventLoop& loop, std::span<uint8_t> buffer, size_t& num, Deadline deadline);
     public:
         Serial();
         explicit Serial(std::string port, uint32_t baudrate);
@@ -55,11 +229,98 @@ namespace serial
         void open(void);
         void close(void);
         
-        // write or read data on serial port
-        uint32_t write(std::string data);
-        uint32_t write(std::vector<uint8_t> data);
+        // open many ports concurrently, the settle times overlap and a failed port does not stop the others
+        static std::vector<OpenResult> open_all(std::span<Serial* const> ports);
+        static std::vector<OpenResult> open_all(std::span<Serial* const> ports, unsigned threads);
+        
+        // write or read data on serial port, writes return after all data is written
+        // one thread may read while other threads write, the data of concurrent writes is never interleaved
+        uint32_t write(std::string_view data);
+        uint32_t write(std::span<const uint8_t> data);
         std::string readline(void);
         std::vector<uint8_t> read(uint32_t size);
+        std::vector<uint8_t> read_until(std::string expected);
+        std::vector<uint8_t> read_until(std::string expected, size_t max_size);
+        
+        // same with a timeout for this call instead of the stored timeout, negative means no timeout
+        std::string readline(std::chrono::nanoseconds timeout);
+        std::vector<uint8_t> read(uint32_t size, std::chrono::nanoseconds timeout);
+        std::vector<uint8_t> read_until(std::string expected, size_t max_size, std::chrono::nanoseconds timeout);
+        
+        // same without exceptions, timeouts and errors are returned as status, for loops in which timeouts are expected
+        SerialStatus try_readline(std::string& line);
+        SerialStatus try_readline(std::string& line, std::chrono::nanoseconds timeout);
+        SerialStatus try_read(std::vector<uint8_t>& data, uint32_t size);
+        SerialStatus try_read(std::vector<uint8_t>& data, uint32_t size, std::chrono::nanoseconds timeout);
+        SerialStatus try_read_until(std::vector<uint8_t>& data, const std::string& expected, size_t max_size);
+        SerialStatus try_read_until(std::vector<uint8_t>& data, const std::string& expected, size_t max_size, std::chrono::nanoseconds timeout);
+        SerialStatus try_read_into(std::span<uint8_t> buffer, size_t& num);
+        SerialStatus try_read_into(std::span<uint8_t> buffer, size_t& num, std::chrono::nanoseconds timeout);
+        SerialStatus try_readline_into(std::span<char> buffer, size_t& num);
+        SerialStatus try_readline_into(std::span<char> buffer, size_t& num, std::chrono::nanoseconds timeout);
+        
+        // read all complete lines which are available, waits for the first line like readline
+        // the lines are views into the receive buffer and valid until the next read, a partial line stays buffered
+        std::vector<std::string_view> readlines(void);
+        std::vector<std::string_view> readlines(std::chrono::nanoseconds timeout);
+        SerialStatus try_readlines(std::vector<std::string_view>& lines);
+        SerialStatus try_readlines(std::vector<std::string_view>& lines, std::chrono::nanoseconds timeout);
+        
+        // read into a buffer of the pool, no heap allocation once the pool holds buffers of the sizes in use
+        PooledBuffer read_pooled(uint32_t size);
+        PooledBuffer read_pooled(uint32_t size, std::chrono::nanoseconds timeout);
+        PooledBuffer readline_pooled(void);
+        PooledBuffer readline_pooled(std::chrono::nanoseconds timeout);
+        SerialStatus try_read_pooled(PooledBuffer& buffer, uint32_t size, std::chrono::nanoseconds timeout);
+        SerialStatus try_readline_pooled(PooledBuffer& buffer, std::chrono::nanoseconds timeout);
+        
+        // write several buffers with one system call
+        size_t write_batch(std::span<const std::span<const uint8_t>> buffers);
+        size_t write_batch(std::span<const std::string_view> buffers);
+        
+        // collect small writes and send them together if tx_threshold is reached or on flush
+        void queue_write(std::string_view data);
+        void queue_write(std::span<const uint8_t> data);
+        void flush(void);
+        
+        // read available data into the receive buffer without waiting
+        size_t receive(void);
+        
+        // buffered bytes, with a callback reader the bytes not yet passed to the callback
+        size_t in_waiting(void);
+        
+        // read data into a caller-owned buffer without heap allocation
+        size_t read_into(std::span<uint8_t> buffer);
+        size_t read_into(uint8_t* buffer, size_t size);
+        size_t readline_into(std::span<char> buffer);
+        size_t readline_into(char* buffer, size_t size);
+        size_t read_into(std::span<uint8_t> buffer, std::chrono::nanoseconds timeout);
+        size_t readline_into(std::span<char> buffer, std::chrono::nanoseconds timeout);
+        
+        // read at least one and at most buffer.size() bytes, whatever is available
+        size_t read_some(std::span<uint8_t> buffer);
+        size_t read_some(std::span<uint8_t> buffer, std::chrono::nanoseconds timeout);
+        SerialStatus try_read_some(std::span<uint8_t> buffer, size_t& num);
+        SerialStatus try_read_some(std::span<uint8_t> buffer, size_t& num, std::chrono::nanoseconds timeout);
+        
+        // coroutines for an EventLoop, only the total timeout applies and the data must be valid until the write is completed
+        Task<std::vector<uint8_t>> async_read(EventLoop& loop, uint32_t size);
+        Task<std::vector<uint8_t>> async_read(EventLoop& loop, uint32_t size, std::chrono::nanoseconds timeout);
+        Task<std::vector<uint8_t>> async_read(EventLoop& loop, uint32_t size, std::chrono::nanoseconds timeout, Cancellation& cancellation);
+        Task<std::string> async_readline(EventLoop& loop);
+        Task<std::string> async_readline(EventLoop& loop, std::chrono::nanoseconds timeout);
+        Task<std::string> async_readline(EventLoop& loop, std::chrono::nanoseconds timeout, Cancellation& cancellation);
+        Task<size_t> async_write(EventLoop& loop, std::string_view data);
+        Task<size_t> async_write(EventLoop& loop, std::span<const uint8_t> data);
+        Task<size_t> async_write(EventLoop& loop, std::span<const uint8_t> data, std::chrono::nanoseconds timeout, Cancellation& cancellation);
+        Task<SerialStatus> async_try_read_some(EventLoop& loop, std::span<uint8_t> buffer, size_t& num, std::chrono::nanoseconds timeout);
+        
+        // background reader thread, which drains the port independent of the application
+        void start_reader(void);
+        void start_reader(ChunkCallback chunk_callback);
+        void start_line_reader(LineCallback line_callback);
+        void stop_reader(void);
+        bool reader_running(void);
         
         // reset serial buffers
         void reset_input_buffer(void);
@@ -73,14 +334,64 @@ namespace serial
         bool cts(void);
         bool dsr(void);
         
+        // low latency settings of the driver and the USB adapter of a TtyTransport, return the applied settings
+        // disabling restores the settings from before the first enable
+        LowLatencyStatus low_latency(bool state);
+        LowLatencyStatus low_latency(void);
+        
         // write or read serial settings
         bool is_open(void);
+        int fileno(void);
         std::string port(void);
         void port(std::string new_port);
         uint32_t baudrate(void);
         void baudrate(uint32_t new_baudrate);
         float timeout(void);
         void timeout(float new_timeout);
+        float inter_byte_timeout(void);
+        void inter_byte_timeout(float new_timeout);
+        float write_timeout(void);
+        void write_timeout(float new_timeout);
+        size_t tx_threshold(void);
+        void tx_threshold(size_t new_threshold);
+        std::string terminator(void);
+        void terminator(std::string new_terminator);
+        
+        // wait for the port after the settings are applied on open
+        SettlePolicy settle_policy(void);
+        void settle_policy(SettlePolicy new_policy);
+        float settle_time(void);
+        void settle_time(float new_time);
+        
+        // spin on non-blocking reads for the budget in seconds before a blocking receive wait, 0 disables busy polling
+        // the overload pins the calling thread and a reader thread started later to the CPU and raises them to SCHED_FIFO
+        // with the priority, -1 and 0 keep them unchanged
+        float busy_poll(void);
+        void busy_poll(float new_budget);
+        void busy_poll(float new_budget, int cpu, int priority);
+        int busy_poll_cpu(void);
+        int busy_poll_priority(void);
+        
+        // pool of the pooled reads, may be shared between ports
+        BufferPool buffer_pool(void);
+        void buffer_pool(BufferPool pool);
+        
+        // record every chunk read from or written to the port, set while no other thread uses the port
+        Capture capture(void);
+        void capture(Capture new_capture);
+        void capture(Capture new_capture, uint16_t channel);
+        
+        // I/O backend, applied on open, falls back to POSIX if io_uring is not available
+        Backend backend(void);
+        void backend(Backend new_backend);
+        
+        // endpoint below the port, e.g. a pty, a socket or a memory pair, set while the port is closed, a TtyTransport by default
+        std::shared_ptr<Transport> transport(void);
+        void transport(std::shared_ptr<Transport> new_transport);
+        
+        // counters and latency histograms since open or reset_stats, error counters of the driver
+        SerialStats stats(void);
+        void reset_stats(void);
         
         friend std::ostream& operator<< (std::ostream &out, Serial const& serial_obj);
     };
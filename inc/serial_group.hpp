@@ -0,0 +1,89 @@
+/**
+ * @file serial_group.hpp
+ * @brief Serial group header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Event loop for many serial ports based on one epoll instance. Received data
+ * is read into the receive buffer of the port before its readable handler is
+ * called, so the handler can use read and readline on the buffered data
+ * without blocking. Events are dispatched by the thread calling poll or run,
+ * or by a small pool of worker threads. A port is never handled by two
+ * threads at the same time.
+ */
+
+
+#ifndef SERIAL_GROUP_HPP
+#define SERIAL_GROUP_HPP
+
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <cstddef>
+#include <cstdint>
+
+#include "serial.hpp"
+
+
+namespace serial
+{
+    typedef std::function<void(Serial&)> SerialHandler;
+    typedef std::function<void(Serial&, const std::exception&)> SerialErrorHandler;
+    
+    
+    class SerialGroup
+    {
+    private:
+        struct Member
+        {
+            Serial* serial;
+            int fd;
+            SerialHandler readable_handler;
+            SerialHandler writable_handler;
+            bool writable_flag;                         // writable events requested
+            bool removed_flag;
+        };
+        
+        int epoll_fd;
+        int wake_fd;                                    // stops run and the worker threads
+        std::vector<std::unique_ptr<Member>> members;
+        std::vector<std::unique_ptr<Member>> removed_members;   // freed after the current dispatch
+        SerialErrorHandler error_handler_stored;
+        std::vector<std::thread> workers;
+        std::atomic<bool> stop_flag;
+        bool oneshot_flag;                              // members are handled by worker threads
+        
+        Member* find(Serial& serial);
+        void update(Member* member, int operation);
+        void dispatch(Member* member, uint32_t events);
+        size_t wait(int timeout_ms);
+        void worker_loop(void);
+    public:
+        SerialGroup();
+        SerialGroup(const SerialGroup&) = delete;
+        ~SerialGroup();
+        
+        // ports of the group, changes are only allowed while no worker threads are running
+        void add(Serial& serial, SerialHandler readable_handler);
+        void add(Serial& serial, SerialHandler readable_handler, SerialHandler writable_handler);
+        void remove(Serial& serial);
+        void writable(Serial& serial, bool state);
+        void error_handler(SerialErrorHandler handler);
+        size_t size(void);
+        
+        // dispatch events in the calling thread
+        size_t poll(float timeout);
+        void run(void);
+        
+        // dispatch events in worker threads
+        void start(unsigned threads);
+        void stop(void);
+    };
+}
+
+
+#endif
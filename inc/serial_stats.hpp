@@ -0,0 +1,128 @@
+/**
+ * @file serial_stats.hpp
+ * @brief Serial statistics header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Counters and latency histograms of a serial port. The histograms have 16
+ * linear sub-buckets per power of two, like HDR histograms, so a value is
+ * stored with a relative error of at most 1/16 in a fixed array. The port
+ * records with relaxed atomic operations without locks, so the reader thread
+ * can record too and a snapshot can be taken from any thread.
+ */
+
+
+#ifndef SERIAL_STATS_HPP
+#define SERIAL_STATS_HPP
+
+
+#include <iostream>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+
+#define SERIAL_HISTOGRAM_SUB_BUCKETS            16                                  // linear buckets per power of two
+#define SERIAL_HISTOGRAM_MAX_EXPONENT           40                                  // values up to 2^40 ns, about 18 minutes
+#define SERIAL_HISTOGRAM_BUCKETS                ((SERIAL_HISTOGRAM_MAX_EXPONENT - 3) * SERIAL_HISTOGRAM_SUB_BUCKETS)
+
+
+namespace serial
+{
+    class Histogram
+    {
+    public:
+        std::array<uint64_t, SERIAL_HISTOGRAM_BUCKETS> counts;
+        uint64_t total;                                 // number of recorded values
+        uint64_t sum;
+        uint64_t max;
+        
+        Histogram(void);
+        
+        uint64_t count(void) const;
+        double mean(void) const;
+        uint64_t percentile(double p) const;            // p in [0, 1], upper bound of the bucket
+        
+        static size_t bucket(uint64_t value);
+        static uint64_t bucket_limit(size_t index);     // largest value stored in the bucket
+    };
+    
+    
+    struct SerialStats
+    {
+        uint64_t rx_bytes;
+        uint64_t tx_bytes;
+        uint64_t rx_syscalls;                           // read and poll calls for receiving
+        uint64_t tx_syscalls;                           // write and poll calls for sending
+        uint64_t rx_timeouts;                           // waits for received data ended by a timeout
+        uint64_t tx_timeouts;
+        uint64_t partial_writes;                        // write calls which took only a part of the data
+        Histogram read_wait;                            // time blocked waiting for received data in ns
+        Histogram write_time;                           // time until a write call completed in ns
+        uint64_t spin_hits;                             // receive waits ended by data while busy polling
+        uint64_t spin_misses;                           // receive waits which blocked after the spin budget
+        Histogram spin_wait;                            // time spinning until data arrived in ns
+        
+        bool icount_valid;                              // TIOCGICOUNT is supported by the driver
+        uint64_t frame_errors;
+        uint64_t parity_errors;
+        uint64_t overruns;                              // UART overruns, the driver read too slowly
+        uint64_t buffer_overruns;                       // tty buffer overruns, the application read too slowly
+        uint64_t breaks;
+    };
+    
+    
+    // live counters of a port
+    class StatsRecorder
+    {
+    private:
+        struct AtomicHistogram
+        {
+            std::array<std::atomic<uint64_t>, SERIAL_HISTOGRAM_BUCKETS> counts;
+            std::atomic<uint64_t> sum;
+            std::atomic<uint64_t> max;
+        };
+        
+        std::atomic<uint64_t> rx_bytes;
+        std::atomic<uint64_t> tx_bytes;
+        std::atomic<uint64_t> rx_syscalls;
+        std::atomic<uint64_t> tx_syscalls;
+        std::atomic<uint64_t> rx_timeouts;
+        std::atomic<uint64_t> tx_timeouts;
+        std::atomic<uint64_t> partial_writes;
+        AtomicHistogram read_wait;
+        AtomicHistogram write_time;
+        std::atomic<uint64_t> spin_hits;
+        std::atomic<uint64_t> spin_misses;
+        AtomicHistogram spin_wait;
+        
+        static void record(AtomicHistogram& histogram, uint64_t value);
+        static void copy(const AtomicHistogram& histogram, Histogram& output);
+        static void clear(AtomicHistogram& histogram);
+    public:
+        StatsRecorder(void);
+        StatsRecorder(const StatsRecorder&) = delete;
+        
+        void rx_syscall(void);                          // poll call for receiving
+        void tx_syscall(void);                          // poll call for sending
+        void received(size_t bytes);                    // read call
+        void sent(size_t bytes, bool partial);          // write call
+        void rx_wait(uint64_t ns, bool timeout);        // wait for received data
+        void tx_timeout(void);
+        void write_completed(uint64_t ns);
+        void spin(uint64_t ns, bool hit);               // busy polling, ended by data or by the budget
+        
+        void snapshot(SerialStats& stats) const;
+        void reset(void);
+    };
+    
+    
+    std::ostream& operator<< (std::ostream &out, SerialStats const& stats);
+}
+
+
+#endif
+
+
+
@@ -0,0 +1,71 @@
+/**
+ * @file spsc_ring.hpp
+ * @brief Single-producer/single-consumer ring header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Lock-free byte ring for exactly one producer thread and one consumer thread.
+ * Both sides work on contiguous spans of the storage, so data can be read from
+ * a file descriptor directly into the ring. Waiting for data or free space
+ * only issues a futex call if the ring is actually empty or full.
+ */
+
+
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+
+#include <vector>
+#include <span>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <time.h>
+
+
+namespace serial
+{
+    class SpscRing
+    {
+    private:
+        std::vector<uint8_t> storage;
+        size_t mask;                                    // capacity is a power of two
+        
+        alignas(64) std::atomic<size_t> head;           // consumer position
+        alignas(64) std::atomic<size_t> tail;           // producer position
+        alignas(64) std::atomic<uint32_t> data_event;   // futex words, incremented to wake a waiting side
+        std::atomic<uint32_t> space_event;
+        std::atomic<bool> consumer_waiting;
+        std::atomic<bool> producer_waiting;
+        std::atomic<bool> closed_flag;
+        
+        bool wait(std::atomic<uint32_t>& event, std::atomic<bool>& waiting, bool (SpscRing::*ready)(void) const, const struct timespec* timeout);
+        bool readable(void) const;
+        bool writable(void) const;
+    public:
+        explicit SpscRing(size_t capacity);
+        SpscRing(const SpscRing&) = delete;
+        
+        // producer side
+        std::span<uint8_t> write_span(void);
+        void produce(size_t size);
+        bool wait_writable(const struct timespec* timeout);
+        
+        // consumer side
+        std::span<const uint8_t> read_span(void);
+        void consume(size_t size);
+        size_t read(uint8_t* buffer, size_t size);
+        bool wait_readable(const struct timespec* timeout);
+        
+        // wake up both sides, waiting returns false afterwards
+        void close(void);
+        bool is_closed(void) const;
+        
+        size_t size(void) const;
+        size_t capacity(void) const;
+    };
+}
+
+
+#endif
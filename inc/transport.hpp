@@ -0,0 +1,165 @@
+/**
+ * @file transport.hpp
+ * @brief Transport header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * I/O below a Serial. A transport opens an endpoint and returns a
+ * non-blocking file descriptor, which poll and epoll report readable when
+ * data is available, so the blocking, the reader thread, the SerialGroup and
+ * the EventLoop functions of Serial work unchanged on every transport. Data
+ * is transferred, flushed and the control lines are accessed through the
+ * transport. TtyTransport is the default and drives real serial ports with
+ * termios. PtyTransport creates a pty pair and drives its slave side, with
+ * the control lines kept locally, since ptys have none. UnixSocketTransport
+ * connects to a stream socket. MemoryTransport pairs are connected by two
+ * lock-free rings, so the library can be measured without the kernel tty
+ * layer. Their descriptor only reports received data, so the async writes and
+ * the writable events of a SerialGroup, which wait for space on the
+ * descriptor, are rejected on a memory pair instead of spinning.
+ */
+
+
+#ifndef TRANSPORT_HPP
+#define TRANSPORT_HPP
+
+
+#include <string>
+#include <memory>
+#include <utility>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <time.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "spsc_ring.hpp"
+
+
+#define TRANSPORT_MEMORY_CAPACITY               65536                               // default ring size of a memory pair in Bytes, like a pipe
+
+
+namespace serial
+{
+    class Transport
+    {
+    protected:
+        int fd;                                         // descriptor of the open endpoint, -1 if closed
+        int lines_stored;                               // TIOCM bits of transports without control lines
+    public:
+        Transport();
+        Transport(const Transport&) = delete;
+        virtual ~Transport();
+        
+        // open the endpoint, throw SerialError on failure and return the descriptor
+        virtual int open(const std::string& port, uint32_t baudrate) = 0;
+        virtual bool close(void) = 0;
+        int fileno(void);
+        
+        // like read and writev on a non-blocking descriptor, -1 with errno EAGAIN if no data or space is available
+        virtual ssize_t read(uint8_t* buffer, size_t size);
+        virtual ssize_t writev(const struct iovec* iov, int count);
+        
+        // wait for POLLIN or POLLOUT, returns 1 if ready, 0 on timeout and -1 on error
+        virtual int wait(short events, const struct timespec* timeout);
+        
+        // discard data which is not yet transferred, the default reads and discards the received data
+        virtual bool flush(bool input, bool output);
+        
+        // the default accepts every baudrate, for transports without a line rate
+        virtual bool baudrate(uint32_t baudrate);
+        
+        // control lines as TIOCM bits, the default keeps the written lines locally and reads no input lines
+        virtual bool set_lines(int lines, bool state);
+        virtual bool get_lines(int& lines);
+        
+        // the descriptor can be read and written by io_uring directly
+        virtual bool direct_io(void);
+        
+        // poll and epoll report the descriptor writable only while data can be written
+        virtual bool output_events(void);
+    };
+    
+    
+    // serial port with termios, the port is locked with flock against other processes
+    class TtyTransport : public Transport
+    {
+    public:
+        int open(const std::string& port, uint32_t baudrate) override;
+        bool close(void) override;
+        bool flush(bool input, bool output) override;
+        bool baudrate(uint32_t baudrate) override;
+        bool set_lines(int lines, bool state) override;
+        bool get_lines(int& lines) override;
+    };
+    
+    
+    // new pty pair on every open, the port name is ignored, the peer descriptor plays the device
+    class PtyTransport : public TtyTransport
+    {
+    private:
+        int peer_fd_stored;
+        std::string name_stored;
+    public:
+        PtyTransport();
+        ~PtyTransport();
+        
+        int open(const std::string& port, uint32_t baudrate) override;
+        bool close(void) override;
+        bool set_lines(int lines, bool state) override;
+        bool get_lines(int& lines) override;
+        
+        // master side and name of the slave side of the open pty
+        int peer_fd(void);
+        std::string name(void);
+    };
+    
+    
+    // stream socket, the port is the path of the socket
+    class UnixSocketTransport : public Transport
+    {
+    public:
+        int open(const std::string& port, uint32_t baudrate) override;
+        bool close(void) override;
+        
+        // the end of the stream is an error instead of no data like on a tty
+        ssize_t read(uint8_t* buffer, size_t size) override;
+    };
+    
+    
+    struct MemoryLink;
+    
+    
+    // one end of an in-memory pair, the data written to one end is read from the other
+    class MemoryTransport : public Transport
+    {
+    private:
+        std::shared_ptr<MemoryLink> rx_link;
+        std::shared_ptr<MemoryLink> tx_link;
+        
+        explicit MemoryTransport(std::shared_ptr<MemoryLink> rx_link, std::shared_ptr<MemoryLink> tx_link);
+    public:
+        static std::pair<std::shared_ptr<MemoryTransport>, std::shared_ptr<MemoryTransport>> pair(void);
+        static std::pair<std::shared_ptr<MemoryTransport>, std::shared_ptr<MemoryTransport>> pair(size_t capacity);
+        
+        // the port name and the baudrate are ignored
+        int open(const std::string& port, uint32_t baudrate) override;
+        bool close(void) override;
+        ssize_t read(uint8_t* buffer, size_t size) override;
+        ssize_t writev(const struct iovec* iov, int count) override;
+        int wait(short events, const struct timespec* timeout) override;
+        
+        // RTS and DTR of one end are CTS and DSR of the other end, like a null modem cable
+        bool set_lines(int lines, bool state) override;
+        bool get_lines(int& lines) override;
+        bool direct_io(void) override;
+        
+        // the descriptor is the eventfd of the received data, which is always writable
+        bool output_events(void) override;
+    };
+}
+
+
+#endif
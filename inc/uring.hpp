@@ -0,0 +1,72 @@
+/**
+ * @file uring.hpp
+ * @brief io_uring header file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ * 
+ * Minimal io_uring instance based on the system calls, without liburing.
+ * A port submits a poll linked to the read or write, so waiting and the
+ * transfer take one io_uring_enter call instead of a poll and a read call.
+ * The file descriptor is registered, which saves the lookup per operation.
+ */
+
+
+#ifndef URING_HPP
+#define URING_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <time.h>
+#include <linux/io_uring.h>
+
+
+namespace serial
+{
+    class IoUring
+    {
+    private:
+        int ring_fd;
+        void* sq_map;
+        size_t sq_map_size;
+        void* cq_map;
+        size_t cq_map_size;
+        struct io_uring_sqe* sqes;
+        size_t sqes_size;
+        
+        unsigned* sq_head;                              // shared with the kernel
+        unsigned* sq_tail;
+        unsigned* sq_mask;
+        unsigned* sq_array;
+        unsigned* cq_head;
+        unsigned* cq_tail;
+        unsigned* cq_mask;
+        struct io_uring_cqe* cqes;
+        unsigned sq_entries;
+        unsigned prepared_tail;                         // tail including prepared, not yet published entries
+    public:
+        IoUring();
+        IoUring(const IoUring&) = delete;
+        ~IoUring();
+        
+        // false if io_uring is not available, e.g. an old kernel or disabled by seccomp or sysctl
+        bool setup(unsigned entries);
+        bool register_file(int fd);
+        
+        // next submission entry, cleared, NULL if the submission queue is full
+        struct io_uring_sqe* sqe(void);
+        
+        // submit the prepared entries and wait for up to wait_count completions, 0 or -errno, e.g. -ETIME
+        int submit(unsigned wait_count, const struct timespec* timeout);
+        
+        // drop the entries which the kernel did not take yet, returns their number
+        unsigned discard(void);
+        bool completion(struct io_uring_cqe& cqe);
+        
+        static bool supported(void);
+    };
+}
+
+
+#endif
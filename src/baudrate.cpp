@@ -0,0 +1,67 @@
+/**
+ * @file baudrate.cpp
+ * @brief Baudrate configuration source file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ */
+
+
+#include <cstdint>
+
+#include <asm/termbits.h>
+#include <sys/ioctl.h>
+
+#include "baudrate.hpp"
+
+
+#define BAUDRATE_TOLERANCE                      0.02                                // relative deviation of the applied baudrate, which UARTs still receive correctly
+
+
+namespace serial
+{
+    bool set_baudrate(int fd, uint32_t baudrate)
+    {
+        struct termios2 port_settings;
+        
+        if(baudrate == 0)
+            return false;
+        
+        if(ioctl(fd, TCGETS2, &port_settings) != 0)                                         // read existing settings
+            return false;
+        
+        struct termios2 previous_settings = port_settings;
+        
+        port_settings.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+        port_settings.c_cflag |= BOTHER | (BOTHER << IBSHIFT);                              // same arbitrary baudrate for output and input
+        port_settings.c_ospeed = baudrate;
+        port_settings.c_ispeed = baudrate;
+        
+        if(ioctl(fd, TCSETS2, &port_settings) != 0)
+            return false;
+        
+        uint32_t applied = get_baudrate(fd);                                                // the driver rounds to the rates its clock divider can generate
+        uint32_t deviation = (applied > baudrate) ? applied - baudrate : baudrate - applied;
+        
+        if((double)deviation > baudrate * BAUDRATE_TOLERANCE)
+        {
+            ioctl(fd, TCSETS2, &previous_settings);                                         // do not keep a rate the caller did not ask for
+            return false;
+        }
+        
+        return true;
+    }
+    
+    
+    uint32_t get_baudrate(int fd)
+    {
+        struct termios2 port_settings;
+        
+        if(ioctl(fd, TCGETS2, &port_settings) != 0)
+            return 0;
+        
+        return port_settings.c_ospeed;
+    }
+}
+
+
+
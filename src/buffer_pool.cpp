@@ -0,0 +1,310 @@
+/**
+ * @file buffer_pool.cpp
+ * @brief Buffer pool source file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ */
+
+
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <atomic>
+#include <new>
+#include <span>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+#include "buffer_pool.hpp"
+
+
+#define BUFFER_POOL_MIN_SHIFT                   6                                   // smallest buffer 64 Bytes
+#define BUFFER_POOL_CLASSES                     19                                  // largest pooled buffer 16 MiB, larger ones are not cached
+
+
+namespace serial
+{
+    struct PoolBlock
+    {
+        std::atomic<uint32_t> references;
+        PoolBlock* next;                                // free list
+        std::shared_ptr<PoolState> state;               // set while the buffer is handed out, keeps the pool alive
+        uint32_t size_class;
+        size_t capacity;
+        size_t size;
+        
+        uint8_t* data(void)
+        {
+            return (uint8_t*)(this + 1);                                                    // the data follows the header
+        }
+    };
+    
+    
+    struct PoolState
+    {
+        std::pmr::memory_resource* resource;
+        std::mutex mutex;
+        PoolBlock* free_lists[BUFFER_POOL_CLASSES];
+        size_t allocations;
+        size_t cached;
+        
+        explicit PoolState(std::pmr::memory_resource* resource) : resource(resource)
+        {
+            for(size_t i = 0; i < BUFFER_POOL_CLASSES; i++)
+                this->free_lists[i] = NULL;
+            
+            this->allocations = 0;
+            this->cached = 0;
+        }
+        
+        ~PoolState()
+        {
+            this->trim();
+        }
+        
+        void free_block(PoolBlock* block)
+        {
+            size_t capacity = block->capacity;
+            block->~PoolBlock();
+            this->resource->deallocate(block, sizeof(PoolBlock) + capacity, alignof(PoolBlock));
+        }
+        
+        void trim(void)
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            
+            for(size_t i = 0; i < BUFFER_POOL_CLASSES; i++)
+            {
+                while(this->free_lists[i] != NULL)
+                {
+                    PoolBlock* block = this->free_lists[i];
+                    this->free_lists[i] = block->next;
+                    this->free_block(block);
+                    this->cached--;
+                }
+            }
+        }
+    };
+    
+    
+    static uint32_t size_class(size_t capacity)
+    {
+        uint32_t result = 0;
+        
+        while(result < BUFFER_POOL_CLASSES && ((size_t)1 << (result + BUFFER_POOL_MIN_SHIFT)) < capacity)
+            result++;
+        
+        return result;                                                                      // BUFFER_POOL_CLASSES if the buffer is too large to be cached
+    }
+    
+    
+    static void release(PoolBlock* block)
+    {
+        if(block == NULL || block->references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+        
+        std::shared_ptr<PoolState> state = std::move(block->state);                         // last reference, the pool may be destroyed without it
+        
+        if(block->size_class >= BUFFER_POOL_CLASSES)
+        {
+            state->free_block(block);
+            return;
+        }
+        
+        std::lock_guard<std::mutex> lock(state->mutex);
+        block->next = state->free_lists[block->size_class];
+        state->free_lists[block->size_class] = block;
+        state->cached++;
+    }
+    
+    
+    PooledBuffer::PooledBuffer()
+    {
+        this->block = NULL;
+    }
+    
+    
+    PooledBuffer::PooledBuffer(PoolBlock* block)
+    {
+        this->block = block;
+    }
+    
+    
+    PooledBuffer::PooledBuffer(const PooledBuffer& other)
+    {
+        this->block = other.block;
+        
+        if(this->block != NULL)
+            this->block->references.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    
+    PooledBuffer::PooledBuffer(PooledBuffer&& other) noexcept
+    {
+        this->block = other.block;
+        other.block = NULL;
+    }
+    
+    
+    PooledBuffer& PooledBuffer::operator= (const PooledBuffer& other)
+    {
+        if(other.block != NULL)
+            other.block->references.fetch_add(1, std::memory_order_relaxed);
+        
+        release(this->block);
+        this->block = other.block;
+        
+        return *this;
+    }
+    
+    
+    PooledBuffer& PooledBuffer::operator= (PooledBuffer&& other) noexcept
+    {
+        if(this != &other)
+        {
+            release(this->block);
+            this->block = other.block;
+            other.block = NULL;
+        }
+        
+        return *this;
+    }
+    
+    
+    PooledBuffer::~PooledBuffer()
+    {
+        release(this->block);
+    }
+    
+    
+    const uint8_t* PooledBuffer::data(void) const
+    {
+        return (this->block != NULL) ? this->block->data() : NULL;
+    }
+    
+    
+    uint8_t* PooledBuffer::data(void)
+    {
+        return (this->block != NULL) ? this->block->data() : NULL;
+    }
+    
+    
+    size_t PooledBuffer::size(void) const
+    {
+        return (this->block != NULL) ? this->block->size : 0;
+    }
+    
+    
+    size_t PooledBuffer::capacity(void) const
+    {
+        return (this->block != NULL) ? this->block->capacity : 0;
+    }
+    
+    
+    bool PooledBuffer::empty(void) const
+    {
+        return this->size() == 0;
+    }
+    
+    
+    std::span<const uint8_t> PooledBuffer::span(void) const
+    {
+        return std::span<const uint8_t>(this->data(), this->size());
+    }
+    
+    
+    std::string_view PooledBuffer::view(void) const
+    {
+        return std::string_view((const char*)this->data(), this->size());
+    }
+    
+    
+    void PooledBuffer::resize(size_t new_size)
+    {
+        if(this->block != NULL)
+            this->block->size = (new_size < this->block->capacity) ? new_size : this->block->capacity;
+    }
+    
+    
+    void PooledBuffer::reset(void)
+    {
+        release(this->block);
+        this->block = NULL;
+    }
+    
+    
+    uint32_t PooledBuffer::use_count(void) const
+    {
+        return (this->block != NULL) ? this->block->references.load(std::memory_order_relaxed) : 0;
+    }
+    
+    
+    BufferPool::BufferPool() : BufferPool::BufferPool(std::pmr::new_delete_resource()) {}
+    
+    
+    BufferPool::BufferPool(std::pmr::memory_resource* resource)
+    {
+        this->state = std::make_shared<PoolState>(resource);
+    }
+    
+    
+    PooledBuffer BufferPool::acquire(size_t min_capacity)
+    {
+        uint32_t index = size_class(min_capacity);
+        PoolBlock* block = NULL;
+        
+        {
+            std::lock_guard<std::mutex> lock(this->state->mutex);
+            
+            if(index < BUFFER_POOL_CLASSES && this->state->free_lists[index] != NULL)       // reuse a released buffer
+            {
+                block = this->state->free_lists[index];
+                this->state->free_lists[index] = block->next;
+                this->state->cached--;
+            }
+            else
+                this->state->allocations++;
+        }
+        
+        if(block == NULL)
+        {
+            size_t capacity = (index < BUFFER_POOL_CLASSES) ? ((size_t)1 << (index + BUFFER_POOL_MIN_SHIFT)) : min_capacity;
+            void* memory = this->state->resource->allocate(sizeof(PoolBlock) + capacity, alignof(PoolBlock));
+            
+            block = new(memory) PoolBlock();
+            block->size_class = index;
+            block->capacity = capacity;
+        }
+        
+        block->references.store(1, std::memory_order_relaxed);
+        block->next = NULL;
+        block->state = this->state;
+        block->size = 0;
+        
+        return PooledBuffer(block);
+    }
+    
+    
+    size_t BufferPool::allocations(void) const
+    {
+        std::lock_guard<std::mutex> lock(this->state->mutex);
+        return this->state->allocations;
+    }
+    
+    
+    size_t BufferPool::cached(void) const
+    {
+        std::lock_guard<std::mutex> lock(this->state->mutex);
+        return this->state->cached;
+    }
+    
+    
+    void BufferPool::trim(void)
+    {
+        this->state->trim();
+    }
+}
+
+
+
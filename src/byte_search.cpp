@@ -0,0 +1,263 @@
+/**
+ * @file byte_search.cpp
+ * @brief Byte search source file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ */
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BYTE_SEARCH_X86
+#include <immintrin.h>
+#endif
+
+#include "byte_search.hpp"
+
+
+namespace serial
+{
+    /* scalar kernels */
+    
+    static const uint8_t* find_byte_scalar(const uint8_t* data, size_t size, uint8_t value)
+    {
+        for(size_t i = 0; i < size; i++)
+        {
+            if(data[i] == value)
+                return data + i;
+        }
+        
+        return NULL;
+    }
+    
+    
+    static const uint8_t* find_sequence_scalar(const uint8_t* data, size_t size, const uint8_t* pattern, size_t pattern_size)
+    {
+        if(pattern_size > size)
+            return NULL;
+        
+        for(size_t i = 0; i <= size - pattern_size; i++)
+        {
+            if(data[i] == pattern[0] && std::memcmp(data + i + 1, pattern + 1, pattern_size - 1) == 0)
+                return data + i;
+        }
+        
+        return NULL;
+    }
+    
+    
+#ifdef BYTE_SEARCH_X86
+    /* SSE2 kernels, 16 bytes per step */
+    
+    __attribute__((target("sse2")))
+    static const uint8_t* find_byte_sse2(const uint8_t* data, size_t size, uint8_t value)
+    {
+        const __m128i needle = _mm_set1_epi8((char)value);
+        size_t i = 0;
+        
+        for(; i + 16 <= size; i += 16)
+        {
+            __m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+            unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+            
+            if(mask != 0)
+                return data + i + __builtin_ctz(mask);
+        }
+        
+        return find_byte_scalar(data + i, size - i, value);
+    }
+    
+    
+    __attribute__((target("sse2")))
+    static const uint8_t* find_sequence_sse2(const uint8_t* data, size_t size, const uint8_t* pattern, size_t pattern_size)
+    {
+        // the dispatcher only passes patterns of two or more bytes
+        if(pattern_size > size)
+            return NULL;
+        
+        const __m128i first = _mm_set1_epi8((char)pattern[0]);
+        const __m128i last = _mm_set1_epi8((char)pattern[pattern_size - 1]);
+        size_t positions = size - pattern_size + 1;                                         // possible start positions
+        size_t i = 0;
+        
+        for(; i + 16 <= positions; i += 16)
+        {
+            __m128i block_first = _mm_loadu_si128((const __m128i*)(data + i));
+            __m128i block_last = _mm_loadu_si128((const __m128i*)(data + i + pattern_size - 1));
+            unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last)));
+            
+            while(mask != 0)                                                                // candidates with matching first and last byte
+            {
+                size_t pos = i + __builtin_ctz(mask);
+                
+                if(std::memcmp(data + pos + 1, pattern + 1, pattern_size - 2) == 0)
+                    return data + pos;
+                
+                mask &= mask - 1;
+            }
+        }
+        
+        return find_sequence_scalar(data + i, size - i, pattern, pattern_size);
+    }
+    
+    
+    /* AVX2 kernels, 32 bytes per step */
+    
+    __attribute__((target("avx2")))
+    static const uint8_t* find_byte_avx2(const uint8_t* data, size_t size, uint8_t value)
+    {
+        const __m256i needle = _mm256_set1_epi8((char)value);
+        size_t i = 0;
+        
+        for(; i + 128 <= size; i += 128)                                                    // four blocks per step, one branch for all of them
+        {
+            __m256i compare_1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i)), needle);
+            __m256i compare_2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i + 32)), needle);
+            __m256i compare_3 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i + 64)), needle);
+            __m256i compare_4 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i + 96)), needle);
+            __m256i any = _mm256_or_si256(_mm256_or_si256(compare_1, compare_2), _mm256_or_si256(compare_3, compare_4));
+            
+            if(_mm256_testz_si256(any, any) == 0)
+            {
+                uint64_t mask_low = (uint32_t)_mm256_movemask_epi8(compare_1) | ((uint64_t)(uint32_t)_mm256_movemask_epi8(compare_2) << 32);
+                
+                if(mask_low != 0)
+                    return data + i + __builtin_ctzll(mask_low);
+                
+                uint64_t mask_high = (uint32_t)_mm256_movemask_epi8(compare_3) | ((uint64_t)(uint32_t)_mm256_movemask_epi8(compare_4) << 32);
+                
+                return data + i + 64 + __builtin_ctzll(mask_high);
+            }
+        }
+        
+        for(; i + 32 <= size; i += 32)
+        {
+            __m256i block = _mm256_loadu_si256((const __m256i*)(data + i));
+            unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle));
+            
+            if(mask != 0)
+                return data + i + __builtin_ctz(mask);
+        }
+        
+        return find_byte_sse2(data + i, size - i, value);
+    }
+    
+    
+    __attribute__((target("avx2")))
+    static const uint8_t* find_sequence_avx2(const uint8_t* data, size_t size, const uint8_t* pattern, size_t pattern_size)
+    {
+        // the dispatcher only passes patterns of two or more bytes
+        if(pattern_size > size)
+            return NULL;
+        
+        const __m256i first = _mm256_set1_epi8((char)pattern[0]);
+        const __m256i last = _mm256_set1_epi8((char)pattern[pattern_size - 1]);
+        size_t positions = size - pattern_size + 1;                                         // possible start positions
+        size_t i = 0;
+        
+        for(; i + 32 <= positions; i += 32)
+        {
+            __m256i block_first = _mm256_loadu_si256((const __m256i*)(data + i));
+            __m256i block_last = _mm256_loadu_si256((const __m256i*)(data + i + pattern_size - 1));
+            unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last)));
+            
+            while(mask != 0)                                                                // candidates with matching first and last byte
+            {
+                size_t pos = i + __builtin_ctz(mask);
+                
+                if(std::memcmp(data + pos + 1, pattern + 1, pattern_size - 2) == 0)
+                    return data + pos;
+                
+                mask &= mask - 1;
+            }
+        }
+        
+        return find_sequence_sse2(data + i, size - i, pattern, pattern_size);
+    }
+#endif
+    
+    
+    /* runtime dispatch */
+    
+    bool search_kernel_supported(SearchKernel kernel)
+    {
+        switch(kernel)
+        {
+            case SearchKernel::SCALAR :
+                return true;
+#ifdef BYTE_SEARCH_X86
+            case SearchKernel::SSE2 :
+                return __builtin_cpu_supports("sse2");
+            case SearchKernel::AVX2 :
+                return __builtin_cpu_supports("avx2");
+#endif
+            default :
+                return false;
+        }
+    }
+    
+    
+    SearchKernel search_kernel(void)
+    {
+        static const SearchKernel kernel = search_kernel_supported(SearchKernel::AVX2) ? SearchKernel::AVX2 :
+                                           search_kernel_supported(SearchKernel::SSE2) ? SearchKernel::SSE2 :
+                                           SearchKernel::SCALAR;
+        
+        return kernel;
+    }
+    
+    
+    const uint8_t* find_byte(SearchKernel kernel, const uint8_t* data, size_t size, uint8_t value)
+    {
+        switch(kernel)
+        {
+#ifdef BYTE_SEARCH_X86
+            case SearchKernel::AVX2 :
+                return find_byte_avx2(data, size, value);
+            case SearchKernel::SSE2 :
+                return find_byte_sse2(data, size, value);
+#endif
+            default :
+                return find_byte_scalar(data, size, value);
+        }
+    }
+    
+    
+    const uint8_t* find_sequence(SearchKernel kernel, const uint8_t* data, size_t size, const uint8_t* pattern, size_t pattern_size)
+    {
+        if(pattern_size == 0)
+            return data;
+        if(pattern_size == 1)
+            return find_byte(kernel, data, size, pattern[0]);
+        
+        switch(kernel)
+        {
+#ifdef BYTE_SEARCH_X86
+            case SearchKernel::AVX2 :
+                return find_sequence_avx2(data, size, pattern, pattern_size);
+            case SearchKernel::SSE2 :
+                return find_sequence_sse2(data, size, pattern, pattern_size);
+#endif
+            default :
+                return find_sequence_scalar(data, size, pattern, pattern_size);
+        }
+    }
+    
+    
+    const uint8_t* find_byte(const uint8_t* data, size_t size, uint8_t value)
+    {
+        return find_byte(search_kernel(), data, size, value);
+    }
+    
+    
+    const uint8_t* find_sequence(const uint8_t* data, size_t size, const uint8_t* pattern, size_t pattern_size)
+    {
+        return find_sequence(search_kernel(), data, size, pattern, pattern_size);
+    }
+}
+
+
+
@@ -0,0 +1,618 @@
+/**
+ * @file capture.cpp
+ * @brief Capture and replay source file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ */
+
+
+#include <string>
+#include <vector>
+#include <span>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/eventfd.h>
+
+#include "capture.hpp"
+#include "serial.hpp"
+
+
+#define CAPTURE_MAGIC                           "SERCAP\0\0"                        // first 8 Bytes of a capture file
+#define CAPTURE_VERSION                         1
+#define CAPTURE_MIN_CAPACITY                    4096
+#define CAPTURE_ALIGNMENT                       8                                   // records start at multiples of 8 Bytes
+#define CAPTURE_TAG                             0x5345524341505455ULL               // xor of the position in the tag of a complete record
+
+
+namespace serial
+{
+    struct CaptureFileHeader                                                                // 64 Bytes, the ring follows
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t header_size;
+        uint64_t capacity;
+        uint64_t head;                                  // position of the next record, accessed atomically
+        uint64_t dropped;                               // accessed atomically
+        uint8_t reserved[24];
+    };
+    
+    
+    struct CaptureRecordHeader                                                              // 24 Bytes, the data follows
+    {
+        uint64_t tag;                                   // position xor CAPTURE_TAG, written after the rest of the record
+        int64_t timestamp;                              // in ns
+        uint32_t size;
+        uint8_t direction;
+        uint8_t reserved;
+        uint16_t channel;
+    };
+    
+    
+    struct CaptureState
+    {
+        std::string path;
+        int fd;
+        uint8_t* map;
+        size_t map_size;
+        CaptureFileHeader* header;
+        uint8_t* data;
+        uint64_t mask;                                  // capacity is a power of two
+        
+        CaptureState() : fd(-1), map(NULL), map_size(0), header(NULL), data(NULL), mask(0) {}
+        
+        ~CaptureState()
+        {
+            if(this->map != NULL)
+                munmap(this->map, this->map_size);
+            if(this->fd >= 0)
+                ::close(this->fd);
+        }
+        
+        void write(uint64_t position, const void* buffer, size_t size)
+        {
+            uint64_t offset = position & this->mask;
+            size_t first = this->mask + 1 - offset;                                         // space up to the end of the ring
+            
+            if(first >= size)
+            {
+                memcpy(this->data + offset, buffer, size);
+            }
+            else
+            {
+                memcpy(this->data + offset, buffer, first);
+                memcpy(this->data, (const uint8_t*)buffer + first, size - first);
+            }
+        }
+    };
+    
+    
+    static size_t round_up_power_of_two(size_t value)
+    {
+        size_t result = 1;
+        
+        while(result < value)
+            result <<= 1;
+        
+        return result;
+    }
+    
+    
+    static uint64_t record_size(size_t size)
+    {
+        return (sizeof(CaptureRecordHeader) + size + CAPTURE_ALIGNMENT - 1) & ~(uint64_t)(CAPTURE_ALIGNMENT - 1);
+    }
+    
+    
+    Capture::Capture()
+    {
+    }
+    
+    
+    Capture::Capture(const std::string& path, size_t capacity) : state(std::make_shared<CaptureState>())
+    {
+        CaptureState* state = this->state.get();
+        uint64_t ring_size = round_up_power_of_two((capacity > CAPTURE_MIN_CAPACITY) ? capacity : CAPTURE_MIN_CAPACITY);
+        
+        state->path = path;
+        state->fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        
+        if(state->fd < 0)
+            throw SerialError("Capture: Unable to create file.");
+        
+        state->map_size = sizeof(CaptureFileHeader) + ring_size;
+        int status = posix_fallocate(state->fd, 0, state->map_size);                        // no block is allocated while recording
+        
+        if(status == EOPNOTSUPP || status == EINVAL)                                        // file systems without fallocate
+            status = (ftruncate(state->fd, state->map_size) == 0) ? 0 : errno;
+        if(status != 0)
+            throw SerialError("Capture: Unable to allocate file.");
+        
+        void* map = mmap(NULL, state->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, state->fd, 0);
+        
+        if(map == MAP_FAILED)
+            throw SerialError("Capture: Unable to map file.");
+        
+        state->map = (uint8_t*)map;
+        state->header = (CaptureFileHeader*)map;
+        state->data = state->map + sizeof(CaptureFileHeader);
+        state->mask = ring_size - 1;
+        memset(state->data, 0, ring_size);                                                  // write faults of the pages are taken here
+        
+        memcpy(state->header->magic, CAPTURE_MAGIC, sizeof(state->header->magic));
+        state->header->version = CAPTURE_VERSION;
+        state->header->header_size = sizeof(CaptureFileHeader);
+        state->header->capacity = ring_size;
+        state->header->head = 0;
+        state->header->dropped = 0;
+    }
+    
+    
+    bool Capture::active(void) const
+    {
+        return this->state != NULL;
+    }
+    
+    
+    void Capture::record(CaptureDirection direction, uint16_t channel, std::span<const uint8_t> data)
+    {
+        struct iovec iov;
+        iov.iov_base = (void*)data.data();
+        iov.iov_len = data.size();
+        
+        this->record(direction, channel, &iov, 1, data.size());
+    }
+    
+    
+    void Capture::record(CaptureDirection direction, uint16_t channel, const struct iovec* iov, int count, size_t size)
+    {
+        CaptureState* state = this->state.get();
+        
+        if(state == NULL)
+            return;
+        
+        uint64_t total = record_size(size);
+        
+        if(total > state->mask + 1)
+        {
+            std::atomic_ref<uint64_t>(state->header->dropped).fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        
+        uint64_t position = std::atomic_ref<uint64_t>(state->header->head).fetch_add(total, std::memory_order_relaxed);
+        
+        CaptureRecordHeader header;
+        header.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        header.size = size;
+        header.direction = (uint8_t)direction;
+        header.reserved = 0;
+        header.channel = channel;
+        state->write(position + sizeof(header.tag), (const uint8_t*)&header + sizeof(header.tag), sizeof(header) - sizeof(header.tag));
+        
+        uint64_t data_position = position + sizeof(header);
+        
+        for(int i = 0; i < count && size > 0; i++)                                          // only the transferred part of the buffers
+        {
+            size_t num = (iov[i].iov_len < size) ? iov[i].iov_len : size;
+            state->write(data_position, iov[i].iov_base, num);
+            data_position += num;
+            size -= num;
+        }
+        
+        uint64_t* tag = (uint64_t*)(state->data + (position & state->mask));               // aligned, never wraps around the end
+        std::atomic_ref<uint64_t>(*tag).store(position ^ CAPTURE_TAG, std::memory_order_release);
+    }
+    
+    
+    void Capture::sync(void)
+    {
+        if(this->state != NULL && msync(this->state->map, this->state->map_size, MS_SYNC) != 0)
+            throw SerialError("Capture sync: Unable to write file.");
+    }
+    
+    
+    std::string Capture::path(void) const
+    {
+        return (this->state != NULL) ? this->state->path : std::string();
+    }
+    
+    
+    size_t Capture::capacity(void) const
+    {
+        return (this->state != NULL) ? this->state->mask + 1 : 0;
+    }
+    
+    
+    uint64_t Capture::written(void) const
+    {
+        if(this->state == NULL)
+            return 0;
+        
+        return std::atomic_ref<uint64_t>(this->state->header->head).load(std::memory_order_relaxed);
+    }
+    
+    
+    uint64_t Capture::dropped(void) const
+    {
+        if(this->state == NULL)
+            return 0;
+        
+        return std::atomic_ref<uint64_t>(this->state->header->dropped).load(std::memory_order_relaxed);
+    }
+    
+    
+    CaptureReader::CaptureReader(const std::string& path) : fd(-1), map(NULL), map_size(0)
+    {
+        this->fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        
+        if(this->fd < 0)
+            throw SerialError("Capture reader: Unable to open file.");
+        
+        struct stat file_stat;
+        
+        if(fstat(this->fd, &file_stat) != 0 || (size_t)file_stat.st_size < sizeof(CaptureFileHeader))
+        {
+            ::close(this->fd);
+            throw SerialError("Capture reader: Invalid capture file.");
+        }
+        
+        this->map_size = file_stat.st_size;
+        void* map = mmap(NULL, this->map_size, PROT_READ, MAP_SHARED, this->fd, 0);
+        
+        if(map == MAP_FAILED)
+        {
+            ::close(this->fd);
+            throw SerialError("Capture reader: Unable to map file.");
+        }
+        
+        this->map = (uint8_t*)map;
+        CaptureFileHeader* header = (CaptureFileHeader*)map;
+        uint64_t capacity = header->capacity;
+        
+        if(memcmp(header->magic, CAPTURE_MAGIC, sizeof(header->magic)) != 0 || header->version != CAPTURE_VERSION || header->header_size != sizeof(CaptureFileHeader)
+            || capacity == 0 || (capacity & (capacity - 1)) != 0 || sizeof(CaptureFileHeader) + capacity > this->map_size)
+        {
+            munmap(this->map, this->map_size);
+            ::close(this->fd);
+            throw SerialError("Capture reader: Invalid capture file.");
+        }
+        
+        this->data = this->map + sizeof(CaptureFileHeader);
+        this->mask = capacity - 1;
+        this->end = std::atomic_ref<uint64_t>(header->head).load(std::memory_order_acquire);
+        this->start = (this->end > capacity) ? this->end - capacity : 0;                    // older records are overwritten
+        this->dropped_stored = header->dropped;
+        this->position = this->start;
+    }
+    
+    
+    CaptureReader::~CaptureReader()
+    {
+        munmap(this->map, this->map_size);
+        ::close(this->fd);
+    }
+    
+    
+    void CaptureReader::copy(uint64_t position, void* buffer, size_t size)
+    {
+        uint64_t offset = position & this->mask;
+        size_t first = this->mask + 1 - offset;
+        
+        if(first >= size)
+        {
+            memcpy(buffer, this->data + offset, size);
+        }
+        else
+        {
+            memcpy(buffer, this->data + offset, first);
+            memcpy((uint8_t*)buffer + first, this->data, size - first);
+        }
+    }
+    
+    
+    bool CaptureReader::valid(uint64_t position)
+    {
+        uint64_t* tag = (uint64_t*)(this->data + (position & this->mask));
+        
+        return std::atomic_ref<uint64_t>(*tag).load(std::memory_order_acquire) == (position ^ CAPTURE_TAG);
+    }
+    
+    
+    bool CaptureReader::next(CaptureRecord& record)
+    {
+        while(this->position + sizeof(CaptureRecordHeader) <= this->end)
+        {
+            if(this->valid(this->position) == false)                                       // start of the ring in the middle of a record, or an incomplete record
+            {
+                this->position += CAPTURE_ALIGNMENT;
+                continue;
+            }
+            
+            CaptureRecordHeader header;
+            this->copy(this->position, &header, sizeof(header));
+            uint64_t total = record_size(header.size);
+            
+            if(this->position + total > this->end)
+            {
+                this->position += CAPTURE_ALIGNMENT;
+                continue;
+            }
+            
+            uint64_t data_position = this->position + sizeof(header);
+            uint64_t offset = data_position & this->mask;
+            
+            if(offset + header.size <= this->mask + 1)                                      // contiguous, returned without a copy
+            {
+                record.data = std::span<const uint8_t>(this->data + offset, header.size);
+            }
+            else
+            {
+                this->wrap_buffer.resize(header.size);
+                this->copy(data_position, this->wrap_buffer.data(), header.size);
+                record.data = std::span<const uint8_t>(this->wrap_buffer.data(), header.size);
+            }
+            
+            record.timestamp = std::chrono::nanoseconds(header.timestamp);
+            record.direction = (CaptureDirection)header.direction;
+            record.channel = header.channel;
+            this->position += total;
+            
+            return true;
+        }
+        
+        return false;
+    }
+    
+    
+    void CaptureReader::rewind(void)
+    {
+        this->position = this->start;
+    }
+    
+    
+    uint64_t CaptureReader::dropped(void)
+    {
+        return this->dropped_stored;
+    }
+    
+    
+    CaptureReplay::CaptureReplay(const std::string& path) : CaptureReplay(path, CAPTURE_ALL_CHANNELS)
+    {
+    }
+    
+    
+    CaptureReplay::CaptureReplay(const std::string& path, int channel) : reader(path), channel_stored(channel), speed_stored(1.0), slave_fd(-1), wake_fd(-1)
+    {
+        this->finished_flag = false;
+        this->replayed_stored = 0;
+        this->drained_stored = 0;
+        this->master_fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        
+        char name[64];
+        
+        if(this->master_fd < 0 || grantpt(this->master_fd) != 0 || unlockpt(this->master_fd) != 0 || ptsname_r(this->master_fd, name, sizeof(name)) != 0)
+        {
+            if(this->master_fd >= 0)
+                ::close(this->master_fd);
+            throw SerialError("Capture replay: Unable to create pty.");
+        }
+        
+        this->port_stored = name;
+        this->slave_fd = ::open(name, O_RDWR | O_NOCTTY | O_CLOEXEC);
+        this->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        
+        struct termios tty;
+        
+        if(this->slave_fd < 0 || this->wake_fd < 0 || tcgetattr(this->slave_fd, &tty) != 0)
+        {
+            if(this->wake_fd >= 0)
+                ::close(this->wake_fd);
+            if(this->slave_fd >= 0)
+                ::close(this->slave_fd);
+            ::close(this->master_fd);
+            throw SerialError("Capture replay: Unable to create pty.");
+        }
+        
+        cfmakeraw(&tty);                                                                    // no echo of replayed data before the port is opened
+        tcsetattr(this->slave_fd, TCSANOW, &tty);
+    }
+    
+    
+    CaptureReplay::~CaptureReplay()
+    {
+        this->stop();
+        
+        if(this->wake_fd >= 0)
+            ::close(this->wake_fd);
+        if(this->slave_fd >= 0)
+            ::close(this->slave_fd);
+        if(this->master_fd >= 0)
+            ::close(this->master_fd);
+        
+        this->wake_fd = -1;
+        this->slave_fd = -1;
+        this->master_fd = -1;
+    }
+    
+    
+    std::string CaptureReplay::port(void)
+    {
+        return this->port_stored;
+    }
+    
+    
+    void CaptureReplay::start(void)
+    {
+        if(this->thread.joinable() == true)
+            throw SerialError("Capture replay start: Replay is already running.");
+        
+        uint64_t wake_value;
+        
+        if(::read(this->wake_fd, &wake_value, sizeof(wake_value)) < 0) {}                  // reset the wake-up event of the last stop
+        
+        this->reader.rewind();
+        this->finished_flag = false;
+        this->replayed_stored = 0;
+        this->drained_stored = 0;
+        this->thread = std::thread(&CaptureReplay::replay_loop, this);
+    }
+    
+    
+    void CaptureReplay::stop(void)
+    {
+        if(this->thread.joinable() == false)
+            return;
+        
+        uint64_t wake_value = 1;
+        
+        if(::write(this->wake_fd, &wake_value, sizeof(wake_value)) < 0) {}
+        
+        this->thread.join();
+    }
+    
+    
+    bool CaptureReplay::running(void)
+    {
+        return this->thread.joinable();
+    }
+    
+    
+    bool CaptureReplay::finished(void)
+    {
+        return this->finished_flag;
+    }
+    
+    
+    float CaptureReplay::speed(void)
+    {
+        return this->speed_stored;
+    }
+    
+    
+    void CaptureReplay::speed(float new_speed)
+    {
+        if(this->thread.joinable() == true)
+            throw SerialError("Capture replay speed: Replay is running.");
+        if(new_speed < 0.0)
+            throw SerialError("Capture replay speed: Speed must not be negative.");
+        
+        this->speed_stored = new_speed;
+    }
+    
+    
+    uint64_t CaptureReplay::replayed(void)
+    {
+        return this->replayed_stored;
+    }
+    
+    
+    uint64_t CaptureReplay::drained(void)
+    {
+        return this->drained_stored;
+    }
+    
+    
+    bool CaptureReplay::wait(short events, const struct timespec* timeout)
+    {
+        struct pollfd fds[2];
+        fds[0].fd = this->master_fd;
+        fds[0].events = POLLIN | events;
+        fds[1].fd = this->wake_fd;
+        fds[1].events = POLLIN;
+        
+        if(ppoll(fds, 2, timeout, NULL) < 0 && errno != EINTR)
+            return false;
+        if(fds[1].revents != 0)
+            return false;                                                                   // replay is stopped
+        
+        if(fds[0].revents & POLLIN)                                                         // discard the data written by the application
+        {
+            uint8_t buffer[4096];
+            ssize_t num;
+            
+            while((num = ::read(this->master_fd, buffer, sizeof(buffer))) > 0)
+                this->drained_stored += num;
+        }
+        
+        return true;
+    }
+    
+    
+    void CaptureReplay::replay_loop(void)
+    {
+        CaptureRecord record;
+        bool first_flag = true;
+        std::chrono::nanoseconds first_timestamp(0);
+        auto start = std::chrono::steady_clock::now();
+        
+        while(this->reader.next(record) == true)
+        {
+            if(record.direction != CaptureDirection::RX || (this->channel_stored != CAPTURE_ALL_CHANNELS && record.channel != this->channel_stored))
+                continue;
+            
+            if(first_flag == true)                                                          // the replay starts with the first record
+            {
+                first_timestamp = record.timestamp;
+                first_flag = false;
+            }
+            
+            if(this->speed_stored > 0.0)
+            {
+                auto due = start + std::chrono::duration_cast<std::chrono::nanoseconds>((record.timestamp - first_timestamp) / (double)this->speed_stored);
+                
+                while(true)
+                {
+                    auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(due - std::chrono::steady_clock::now()).count();
+                    
+                    if(remaining <= 0)
+                        break;
+                    
+                    struct timespec timeout = {(time_t)(remaining / 1000000000), (long)(remaining % 1000000000)};
+                    
+                    if(this->wait(0, &timeout) == false)
+                        return;
+                }
+            }
+            
+            size_t offset = 0;
+            
+            while(offset < record.data.size())
+            {
+                ssize_t num = ::write(this->master_fd, record.data.data() + offset, record.data.size() - offset);
+                
+                if(num > 0)
+                {
+                    offset += num;
+                    this->replayed_stored += num;
+                }
+                else if(num < 0 && errno != EAGAIN && errno != EINTR)
+                    return;
+                else if(this->wait(POLLOUT, NULL) == false)                                // input queue of the pty is full
+                    return;
+            }
+        }
+        
+        this->finished_flag = true;
+        
+        while(this->wait(0, NULL) == true) {}                                               // keep draining until the replay is stopped
+    }
+}
+
+
+
@@ -0,0 +1,403 @@
+/**
+ * @file crc.cpp
+ * @brief CRC source file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ */
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__)
+#define CRC_X86
+#include <immintrin.h>
+#endif
+
+#include "crc.hpp"
+
+
+#define CRC_PCLMUL_MIN_SIZE                     64                                  // folding needs four 128 bit blocks to start
+
+
+namespace serial
+{
+    /* tables, generated at compile time */
+    
+    struct CrcTables
+    {
+        uint32_t table[8][256];                                                             // table[k] for a byte followed by k bytes
+    };
+    
+    
+    static constexpr CrcTables reflected_tables(uint32_t polynomial)
+    {
+        CrcTables tables = {};
+        
+        for(uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t value = i;
+            
+            for(int bit = 0; bit < 8; bit++)
+                value = (value & 1) ? (value >> 1) ^ polynomial : value >> 1;
+            
+            tables.table[0][i] = value;
+        }
+        
+        for(int k = 1; k < 8; k++)
+        {
+            for(uint32_t i = 0; i < 256; i++)
+                tables.table[k][i] = (tables.table[k - 1][i] >> 8) ^ tables.table[0][tables.table[k - 1][i] & 0xFF];
+        }
+        
+        return tables;
+    }
+    
+    
+    static constexpr CrcTables crc16_tables(uint16_t polynomial)
+    {
+        CrcTables tables = {};
+        
+        for(uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t value = i << 8;
+            
+            for(int bit = 0; bit < 8; bit++)
+                value = (value & 0x8000) ? ((value << 1) ^ polynomial) & 0xFFFF : (value << 1) & 0xFFFF;
+            
+            tables.table[0][i] = value;
+        }
+        
+        for(int k = 1; k < 8; k++)
+        {
+            for(uint32_t i = 0; i < 256; i++)
+                tables.table[k][i] = ((tables.table[k - 1][i] << 8) & 0xFFFF) ^ tables.table[0][tables.table[k - 1][i] >> 8];
+        }
+        
+        return tables;
+    }
+    
+    
+    static constexpr CrcTables crc16_ccitt_tables = crc16_tables(0x1021);
+    static constexpr CrcTables crc16_modbus_tables = reflected_tables(0xA001);              // the reflected kernels also work for 16 bit registers
+    static constexpr CrcTables crc32_tables = reflected_tables(0xEDB88320);
+    static constexpr CrcTables crc32c_tables = reflected_tables(0x82F63B78);
+    
+    
+    /* portable kernels, working on the CRC register without final inversion */
+    
+    static inline uint32_t load_le32(const uint8_t* data)
+    {
+        return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+    }
+    
+    
+    static uint32_t reflected_table(const CrcTables& tables, uint32_t state, const uint8_t* data, size_t size)
+    {
+        for(size_t i = 0; i < size; i++)
+            state = (state >> 8) ^ tables.table[0][(state ^ data[i]) & 0xFF];
+        
+        return state;
+    }
+    
+    
+    static uint32_t reflected_slicing_by_8(const CrcTables& tables, uint32_t state, const uint8_t* data, size_t size)
+    {
+        const uint32_t (*t)[256] = tables.table;
+        
+        for(; size >= 8; data += 8, size -= 8)
+        {
+            uint32_t one = load_le32(data) ^ state;
+            uint32_t two = load_le32(data + 4);
+            
+            state = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF] ^ t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24] ^
+                    t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF] ^ t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+        }
+        
+        return reflected_table(tables, state, data, size);
+    }
+    
+    
+    static uint32_t crc16_table(const CrcTables& tables, uint32_t state, const uint8_t* data, size_t size)
+    {
+        for(size_t i = 0; i < size; i++)
+            state = ((state << 8) & 0xFFFF) ^ tables.table[0][(state >> 8) ^ data[i]];
+        
+        return state;
+    }
+    
+    
+    static uint32_t crc16_slicing_by_8(const CrcTables& tables, uint32_t state, const uint8_t* data, size_t size)
+    {
+        const uint32_t (*t)[256] = tables.table;
+        
+        for(; size >= 8; data += 8, size -= 8)                                              // the 16 bit register only affects the first two bytes
+        {
+            state = t[7][(state >> 8) ^ data[0]] ^ t[6][(state & 0xFF) ^ data[1]] ^ t[5][data[2]] ^ t[4][data[3]] ^
+                    t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+        }
+        
+        return crc16_table(tables, state, data, size);
+    }
+
+
+#ifdef CRC_X86
+    /* hardware kernels */
+    
+    // CRC-32 folding with carry-less multiplication, Intel white paper "Fast CRC Computation for
+    // Generic Polynomials Using PCLMULQDQ Instruction", size must be a multiple of 16 and at least 64
+    __attribute__((target("pclmul,sse4.1")))
+    static uint32_t crc32_pclmul(uint32_t state, const uint8_t* data, size_t size)
+    {
+        alignas(16) static const uint64_t k1k2[2] = {0x0154442BD4, 0x01C6E41596};          // fold by 512 bits
+        alignas(16) static const uint64_t k3k4[2] = {0x01751997D0, 0x00CCAA009E};          // fold by 128 bits
+        alignas(16) static const uint64_t k5k0[2] = {0x0163CD6124, 0x0000000000};          // fold 64 to 32 bits
+        alignas(16) static const uint64_t poly[2] = {0x01DB710641, 0x01F7011641};          // Barrett reduction
+        
+        __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+        
+        x1 = _mm_loadu_si128((const __m128i*)(data + 0x00));
+        x2 = _mm_loadu_si128((const __m128i*)(data + 0x10));
+        x3 = _mm_loadu_si128((const __m128i*)(data + 0x20));
+        x4 = _mm_loadu_si128((const __m128i*)(data + 0x30));
+        x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(state));
+        x0 = _mm_load_si128((const __m128i*)k1k2);
+        data += 64;
+        size -= 64;
+        
+        while(size >= 64)                                                                   // four independent folds in parallel
+        {
+            x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+            x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+            x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+            x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+            
+            x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+            x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+            x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+            x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+            
+            x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)(data + 0x00)));
+            x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(data + 0x10)));
+            x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(data + 0x20)));
+            x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(data + 0x30)));
+            
+            data += 64;
+            size -= 64;
+        }
+        
+        x0 = _mm_load_si128((const __m128i*)k3k4);                                          // fold the four blocks into one
+        
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+        
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+        
+        while(size >= 16)
+        {
+            x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+            x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+            x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i*)data)), x5);
+            
+            data += 16;
+            size -= 16;
+        }
+        
+        x2 = _mm_clmulepi64_si128(x1, x0, 0x10);                                            // fold 128 to 64 bits
+        x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+        x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+        
+        x0 = _mm_loadl_epi64((const __m128i*)k5k0);
+        x2 = _mm_srli_si128(x1, 4);
+        x1 = _mm_and_si128(x1, x3);
+        x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, x0, 0x00), x2);
+        
+        x0 = _mm_load_si128((const __m128i*)poly);                                          // Barrett reduction to 32 bits
+        x2 = _mm_and_si128(x1, x3);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+        x2 = _mm_and_si128(x2, x3);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x1 = _mm_xor_si128(x1, x2);
+        
+        return _mm_extract_epi32(x1, 1);
+    }
+    
+    
+    static uint32_t crc32_hardware(uint32_t state, const uint8_t* data, size_t size)
+    {
+        if(size >= CRC_PCLMUL_MIN_SIZE)
+        {
+            size_t folded = size & ~(size_t)15;
+            
+            state = crc32_pclmul(state, data, folded);
+            data += folded;
+            size -= folded;
+        }
+        
+        return reflected_slicing_by_8(crc32_tables, state, data, size);                     // short input and tail
+    }
+    
+    
+    __attribute__((target("sse4.2")))
+    static uint32_t crc32c_hardware(uint32_t state, const uint8_t* data, size_t size)
+    {
+        uint64_t value = state;
+        
+        for(; size >= 8; data += 8, size -= 8)
+        {
+            uint64_t block;
+            std::memcpy(&block, data, sizeof(block));
+            value = _mm_crc32_u64(value, block);
+        }
+        
+        state = value;
+        
+        for(; size > 0; data++, size--)
+            state = _mm_crc32_u8(state, *data);
+        
+        return state;
+    }
+#endif
+    
+    
+    /* runtime dispatch */
+    
+    bool crc_kernel_supported(Crc type, CrcKernel kernel)
+    {
+        if(type == Crc::NONE)
+            return false;
+        
+        switch(kernel)
+        {
+            case CrcKernel::TABLE :
+            case CrcKernel::SLICING_BY_8 :
+                return true;
+#ifdef CRC_X86
+            case CrcKernel::HARDWARE :
+                if(type == Crc::CRC32)
+                    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+                else if(type == Crc::CRC32C)
+                    return __builtin_cpu_supports("sse4.2");
+                else
+                    return false;
+#endif
+            default :
+                return false;
+        }
+    }
+    
+    
+    CrcKernel crc_kernel(Crc type)
+    {
+        static const bool crc32_hardware_flag = crc_kernel_supported(Crc::CRC32, CrcKernel::HARDWARE);
+        static const bool crc32c_hardware_flag = crc_kernel_supported(Crc::CRC32C, CrcKernel::HARDWARE);
+        
+        if((type == Crc::CRC32 && crc32_hardware_flag == true) || (type == Crc::CRC32C && crc32c_hardware_flag == true))
+            return CrcKernel::HARDWARE;
+        
+        return CrcKernel::SLICING_BY_8;
+    }
+    
+    
+    size_t crc_size(Crc type)
+    {
+        switch(type)
+        {
+            case Crc::CRC16_CCITT :
+            case Crc::CRC16_MODBUS :
+                return 2;
+            case Crc::CRC32 :
+            case Crc::CRC32C :
+                return 4;
+            default :
+                return 0;
+        }
+    }
+    
+    
+    uint32_t crc(Crc type, CrcKernel kernel, const uint8_t* data, size_t size)
+    {
+        switch(type)
+        {
+            case Crc::CRC16_CCITT :
+                if(kernel == CrcKernel::TABLE)
+                    return crc16_table(crc16_ccitt_tables, 0xFFFF, data, size);
+                return crc16_slicing_by_8(crc16_ccitt_tables, 0xFFFF, data, size);
+            case Crc::CRC16_MODBUS :
+                if(kernel == CrcKernel::TABLE)
+                    return reflected_table(crc16_modbus_tables, 0xFFFF, data, size);
+                return reflected_slicing_by_8(crc16_modbus_tables, 0xFFFF, data, size);
+            case Crc::CRC32 :
+#ifdef CRC_X86
+                if(kernel == CrcKernel::HARDWARE)
+                    return ~crc32_hardware(0xFFFFFFFF, data, size);
+#endif
+                if(kernel == CrcKernel::TABLE)
+                    return ~reflected_table(crc32_tables, 0xFFFFFFFF, data, size);
+                return ~reflected_slicing_by_8(crc32_tables, 0xFFFFFFFF, data, size);
+            case Crc::CRC32C :
+#ifdef CRC_X86
+                if(kernel == CrcKernel::HARDWARE)
+                    return ~crc32c_hardware(0xFFFFFFFF, data, size);
+#endif
+                if(kernel == CrcKernel::TABLE)
+                    return ~reflected_table(crc32c_tables, 0xFFFFFFFF, data, size);
+                return ~reflected_slicing_by_8(crc32c_tables, 0xFFFFFFFF, data, size);
+            default :
+                return 0;
+        }
+    }
+    
+    
+    uint32_t crc(Crc type, const uint8_t* data, size_t size)
+    {
+        return crc(type, crc_kernel(type), data, size);
+    }
+    
+    
+    void crc_store(Crc type, uint32_t value, uint8_t* output)
+    {
+        if(type == Crc::CRC16_CCITT)
+        {
+            output[0] = value >> 8;
+            output[1] = value;
+        }
+        else if(type == Crc::CRC16_MODBUS)
+        {
+            output[0] = value;
+            output[1] = value >> 8;
+        }
+        else if(type == Crc::CRC32 || type == Crc::CRC32C)
+        {
+            output[0] = value;
+            output[1] = value >> 8;
+            output[2] = value >> 16;
+            output[3] = value >> 24;
+        }
+    }
+    
+    
+    bool crc_check(Crc type, const uint8_t* data, size_t size)
+    {
+        size_t check_size = crc_size(type);
+        uint8_t expected[4];
+        
+        if(size < check_size)
+            return false;
+        
+        crc_store(type, crc(type, data, size - check_size), expected);
+        
+        return std::memcmp(expected, data + size - check_size, check_size) == 0;
+    }
+}
+
+
+
@@ -0,0 +1,482 @@
+/**
+ * @file event_loop.cpp
+ * @brief Event loop source file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ */
+
+
+#include <coroutine>
+#include <exception>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <atomic>
+#include <algorithm>
+
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+
+#include "event_loop.hpp"
+#include "serial.hpp"
+
+
+#define EVENT_LOOP_MAX_EVENTS                   64                                  // events handled per epoll_wait call
+
+
+namespace serial
+{
+    // epoll_pwait2 takes the timeout in nanoseconds, epoll_wait only in milliseconds
+    static int wait_events(int epoll_fd, struct epoll_event* events, const struct timespec* timeout)
+    {
+#ifdef SYS_epoll_pwait2
+        static std::atomic<bool> pwait2_flag(true);                                         // cleared if the kernel is older than 5.11
+        
+        if(pwait2_flag.load(std::memory_order_relaxed) == true)
+        {
+            int num = syscall(SYS_epoll_pwait2, epoll_fd, events, EVENT_LOOP_MAX_EVENTS, timeout, NULL, 0);
+            
+            if(num >= 0 || errno != ENOSYS)
+                return num;
+            
+            pwait2_flag.store(false, std::memory_order_relaxed);
+        }
+#endif
+        int timeout_ms = -1;
+        
+        if(timeout != NULL)
+            timeout_ms = timeout->tv_sec * 1000 + (timeout->tv_nsec + 999999) / 1000000;   // round up, never wake too early
+        
+        return epoll_wait(epoll_fd, events, EVENT_LOOP_MAX_EVENTS, timeout_ms);
+    }
+    
+    
+    // coroutine owning a spawned task, destroys itself when the task is completed
+    struct EventLoop::Detached
+    {
+        struct promise_type
+        {
+            EventLoop* loop;
+            
+            promise_type(EventLoop* loop, Task<void>&) : loop(loop)
+            {
+                this->loop->detached_tasks.insert(std::coroutine_handle<promise_type>::from_promise(*this).address());
+            }
+            
+            ~promise_type()
+            {
+                this->loop->detached_tasks.erase(std::coroutine_handle<promise_type>::from_promise(*this).address());
+            }
+            
+            Detached get_return_object(void)
+            {
+                return Detached{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+            
+            std::suspend_always initial_suspend(void) noexcept
+            {
+                return {};                                                                  // started by run
+            }
+            
+            std::suspend_never final_suspend(void) noexcept
+            {
+                return {};
+            }
+            
+            void return_void(void) {}
+            void unhandled_exception(void) {}
+        };
+        
+        std::coroutine_handle<promise_type> handle;
+    };
+    
+    
+    Cancellation::Cancellation()
+    {
+        this->cancelled_flag = false;
+        this->loop = NULL;
+        this->waiter = NULL;
+    }
+    
+    
+    void Cancellation::cancel(void)
+    {
+        this->cancelled_flag = true;
+        
+        if(this->waiter != NULL)                                                            // resume the waiting operation
+            this->loop->complete((EventLoop::Waiter*)this->waiter, WaitResult::CANCELLED);
+    }
+    
+    
+    bool Cancellation::cancelled(void)
+    {
+        return this->cancelled_flag;
+    }
+    
+    
+    void Cancellation::reset(void)
+    {
+        this->cancelled_flag = false;
+    }
+    
+    
+    EventLoop::WaitOperation::WaitOperation(EventLoop* loop, int fd, bool writable, Deadline deadline, Cancellation* cancellation)
+    {
+        this->loop = loop;
+        this->waiter.fd = fd;
+        this->waiter.writable_flag = writable;
+        this->waiter.deadline = deadline;
+        this->waiter.cancellation = cancellation;
+        this->waiter.result = WaitResult::READY;
+        this->waiter.timer_flag = false;
+        this->waiter.suspended_flag = false;
+        this->waiter.queued_flag = false;
+    }
+    
+    
+    EventLoop::WaitOperation::~WaitOperation()
+    {
+        if(this->waiter.suspended_flag == true)                                             // the frame is destroyed, not resumed
+            this->loop->detach(&this->waiter);
+        
+        if(this->waiter.queued_flag == true)
+        {
+            auto entry = std::find(this->loop->ready.begin(), this->loop->ready.end(), this->waiter.handle);
+            
+            if(entry != this->loop->ready.end())
+                this->loop->ready.erase(entry);
+        }
+    }
+    
+    
+    bool EventLoop::WaitOperation::await_ready(void)
+    {
+        if(this->waiter.cancellation != NULL && this->waiter.cancellation->cancelled_flag == true)
+        {
+            this->waiter.result = WaitResult::CANCELLED;
+            return true;
+        }
+        
+        if(this->waiter.fd >= 0)
+        {
+            FdState* state = this->loop->state(this->waiter.fd);
+            bool& ready_flag = (this->waiter.writable_flag == true) ? state->writable_flag : state->readable_flag;
+            Waiter* pending = (this->waiter.writable_flag == true) ? state->writer : state->reader;
+            
+            if(pending != NULL)
+                throw SerialError("Event loop: Another operation waits for the same file descriptor.");
+            
+            if(ready_flag == true)                                                          // edge reported since the last wait
+            {
+                ready_flag = false;
+                this->waiter.result = WaitResult::READY;
+                return true;
+            }
+        }
+        
+        if(this->waiter.deadline != Deadline::max() && this->waiter.deadline <= std::chrono::steady_clock::now())
+        {
+            this->waiter.result = WaitResult::TIMEOUT;
+            return true;
+        }
+        
+        return false;
+    }
+    
+    
+    void EventLoop::WaitOperation::await_suspend(std::coroutine_handle<> handle)
+    {
+        this->loop->suspend(&this->waiter, handle);
+    }
+    
+    
+    WaitResult EventLoop::WaitOperation::await_resume(void)
+    {
+        this->waiter.queued_flag = false;
+        return this->waiter.result;
+    }
+    
+    
+    EventLoop::EventLoop()
+    {
+        this->active_tasks = 0;
+        this->stop_flag = false;
+        this->self = std::make_shared<EventLoop*>(this);
+        this->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        
+        if(this->epoll_fd < 0)
+            throw SerialError("Event loop: Unable to create epoll instance.");
+    }
+    
+    
+    EventLoop::~EventLoop()
+    {
+        std::vector<void*> frames(this->detached_tasks.begin(), this->detached_tasks.end());
+        
+        for(void* frame : frames)                                                           // tasks which did not complete
+            std::coroutine_handle<>::from_address(frame).destroy();
+        
+        *this->self = NULL;                                                                 // ports used with the loop must not remove their fd
+        ::close(this->epoll_fd);
+    }
+    
+    
+    EventLoop::Detached EventLoop::run_detached(EventLoop* loop, Task<void> task)
+    {
+        try
+        {
+            co_await task;
+        }
+        catch(...)
+        {
+            if(!loop->task_exception)
+                loop->task_exception = std::current_exception();
+        }
+        
+        loop->active_tasks--;
+    }
+    
+    
+    void EventLoop::spawn(Task<void> task)
+    {
+        Detached detached = run_detached(this, std::move(task));
+        this->active_tasks++;
+        this->ready.push_back(detached.handle);
+    }
+    
+    
+    void EventLoop::run(void)
+    {
+        this->stop_flag = false;
+        
+        while(this->stop_flag == false)
+        {
+            while(this->ready.empty() == false && this->stop_flag == false)
+            {
+                std::coroutine_handle<> handle = this->ready.front();
+                this->ready.pop_front();
+                handle.resume();
+            }
+            
+            if(this->task_exception)
+            {
+                std::exception_ptr exception = this->task_exception;
+                this->task_exception = NULL;
+                std::rethrow_exception(exception);
+            }
+            
+            if(this->active_tasks == 0 || this->stop_flag == true)
+                break;
+            
+            struct timespec timeout_struct = {0, 0};
+            struct timespec* timeout = &timeout_struct;
+            
+            if(this->ready.empty() == true && this->timers.empty() == true)
+                timeout = NULL;                                                             // wait for file descriptors only
+            else if(this->ready.empty() == true)
+            {
+                std::chrono::nanoseconds remaining = this->timers.begin()->first - std::chrono::steady_clock::now();
+                
+                if(remaining.count() > 0)                                                   // timers expire with sub-millisecond resolution, e.g. for frame gaps
+                {
+                    timeout_struct.tv_sec = remaining.count() / 1000000000;
+                    timeout_struct.tv_nsec = remaining.count() % 1000000000;
+                }
+            }
+            
+            this->process(timeout);
+        }
+    }
+    
+    
+    void EventLoop::stop(void)
+    {
+        this->stop_flag = true;
+    }
+    
+    
+    size_t EventLoop::tasks(void)
+    {
+        return this->active_tasks;
+    }
+    
+    
+    EventLoop::WaitOperation EventLoop::readable(int fd, Deadline deadline, Cancellation* cancellation)
+    {
+        return WaitOperation(this, fd, false, deadline, cancellation);
+    }
+    
+    
+    EventLoop::WaitOperation EventLoop::writable(int fd, Deadline deadline, Cancellation* cancellation)
+    {
+        return WaitOperation(this, fd, true, deadline, cancellation);
+    }
+    
+    
+    EventLoop::WaitOperation EventLoop::sleep_until(Deadline deadline, Cancellation* cancellation)
+    {
+        return WaitOperation(this, -1, false, deadline, cancellation);
+    }
+    
+    
+    void EventLoop::remove(int fd)
+    {
+        auto entry = this->fds.find(fd);
+        
+        if(entry == this->fds.end())
+            return;
+        
+        FdState* state = entry->second.get();
+        
+        if(state->reader != NULL)                                                           // the next read reports the error
+            this->complete(state->reader, WaitResult::READY);
+        if(state->writer != NULL)
+            this->complete(state->writer, WaitResult::READY);
+        
+        epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+        this->fds.erase(entry);
+    }
+    
+    
+    std::shared_ptr<EventLoop*> EventLoop::reference(void)
+    {
+        return this->self;
+    }
+    
+    
+    EventLoop::FdState* EventLoop::state(int fd)
+    {
+        auto entry = this->fds.find(fd);
+        
+        if(entry != this->fds.end())
+            return entry->second.get();
+        
+        std::unique_ptr<FdState> state = std::make_unique<FdState>();
+        state->fd = fd;
+        state->reader = NULL;
+        state->writer = NULL;
+        state->readable_flag = false;
+        state->writable_flag = false;
+        
+        struct epoll_event event;
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;                           // registered once, edges are remembered in the state
+        event.data.ptr = state.get();
+        
+        if(epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+            throw SerialError("Event loop: Unable to register file descriptor.");
+        
+        FdState* result = state.get();
+        this->fds.emplace(fd, std::move(state));
+        
+        return result;
+    }
+    
+    
+    void EventLoop::suspend(Waiter* waiter, std::coroutine_handle<> handle)
+    {
+        waiter->handle = handle;
+        waiter->suspended_flag = true;
+        
+        if(waiter->fd >= 0)
+        {
+            FdState* state = this->state(waiter->fd);
+            
+            if(waiter->writable_flag == true)
+                state->writer = waiter;
+            else
+                state->reader = waiter;
+        }
+        
+        if(waiter->deadline != Deadline::max())
+        {
+            waiter->timer = this->timers.emplace(waiter->deadline, waiter);
+            waiter->timer_flag = true;
+        }
+        
+        if(waiter->cancellation != NULL)
+        {
+            waiter->cancellation->loop = this;
+            waiter->cancellation->waiter = waiter;
+        }
+    }
+    
+    
+    void EventLoop::complete(Waiter* waiter, WaitResult result)
+    {
+        this->detach(waiter);
+        waiter->result = result;
+        waiter->queued_flag = true;
+        this->ready.push_back(waiter->handle);                                              // resumed by run, keeps the stack flat
+    }
+    
+    
+    void EventLoop::detach(Waiter* waiter)
+    {
+        waiter->suspended_flag = false;
+        
+        if(waiter->fd >= 0)
+        {
+            auto entry = this->fds.find(waiter->fd);
+            
+            if(entry != this->fds.end())
+            {
+                if(entry->second->reader == waiter)
+                    entry->second->reader = NULL;
+                if(entry->second->writer == waiter)
+                    entry->second->writer = NULL;
+            }
+        }
+        
+        if(waiter->timer_flag == true)
+        {
+            this->timers.erase(waiter->timer);
+            waiter->timer_flag = false;
+        }
+        
+        if(waiter->cancellation != NULL)
+            waiter->cancellation->waiter = NULL;
+    }
+    
+    
+    void EventLoop::process(const struct timespec* timeout)
+    {
+        struct epoll_event events[EVENT_LOOP_MAX_EVENTS];
+        int num = wait_events(this->epoll_fd, events, timeout);
+        
+        if(num < 0 && errno != EINTR)
+            throw SerialError("Event loop: Epoll wait failed.");
+        
+        for(int i = 0; i < num; i++)
+        {
+            FdState* state = (FdState*)events[i].data.ptr;
+            
+            if(events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP))
+            {
+                if(state->reader != NULL)
+                    this->complete(state->reader, WaitResult::READY);
+                else
+                    state->readable_flag = true;
+            }
+            
+            if(events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP))
+            {
+                if(state->writer != NULL)
+                    this->complete(state->writer, WaitResult::READY);
+                else
+                    state->writable_flag = true;
+            }
+        }
+        
+        Deadline now = std::chrono::steady_clock::now();
+        
+        while(this->timers.empty() == false && this->timers.begin()->first <= now)
+            this->complete(this->timers.begin()->second, WaitResult::TIMEOUT);
+    }
+}
+
+
+
@@ -0,0 +1,402 @@
+/**
+ * @file framing.cpp
+ * @brief Frame stream source file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ */
+
+
+#include <vector>
+#include <span>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "framing.hpp"
+#include "byte_search.hpp"
+
+
+#define FRAME_RX_CHUNK_SIZE                     4096                                // minimum free space for one read call
+#define FRAME_DEFAULT_MAX_SIZE                  4096                                // default maximum payload size
+#define FRAME_LENGTH_MAX                        0xFFFF                              // largest length of the 16 bit prefix
+
+#define SLIP_END                                0xC0
+#define SLIP_ESC                                0xDB
+#define SLIP_ESC_END                            0xDC
+#define SLIP_ESC_ESC                            0xDD
+
+
+namespace serial
+{
+    static void reserve_append(std::vector<uint8_t>& output, size_t size)
+    {
+        size_t needed = output.size() + size;
+        
+        if(output.capacity() < needed)                                                      // grow geometrically, frames are often appended in a row
+            output.reserve((needed > 2 * output.capacity()) ? needed : 2 * output.capacity());
+    }
+    
+    
+    long cobs_decode(uint8_t* data, size_t size)
+    {
+        size_t read_pos = 0;
+        size_t write_pos = 0;                                                               // never ahead of read_pos, so decoding in place is safe
+        
+        while(read_pos < size)
+        {
+            uint8_t code = data[read_pos];
+            
+            if(code == 0 || read_pos + code > size)                                         // block would end behind the frame
+                return -1;
+            
+            std::memmove(data + write_pos, data + read_pos + 1, code - 1);
+            write_pos += code - 1;
+            read_pos += code;
+            
+            if(code < 0xFF && read_pos < size)                                              // block ends with an implicit zero
+                data[write_pos++] = 0;
+        }
+        
+        return write_pos;
+    }
+    
+    
+    void cobs_encode(std::span<const uint8_t> payload, std::vector<uint8_t>& output)
+    {
+        const uint8_t* data = payload.data();
+        size_t remaining = payload.size();
+        
+        reserve_append(output, remaining + remaining / 254 + 2);
+        
+        while(true)
+        {
+            size_t block = (remaining < 254) ? remaining : 254;                              // a block holds at most 254 data bytes
+            const uint8_t* zero = (const uint8_t*)std::memchr(data, 0, block);
+            
+            if(zero != NULL)
+            {
+                size_t length = zero - data;
+                output.push_back(length + 1);
+                output.insert(output.end(), data, data + length);
+                data += length + 1;
+                remaining -= length + 1;
+                continue;
+            }
+            
+            output.push_back(block + 1);
+            output.insert(output.end(), data, data + block);
+            data += block;
+            remaining -= block;
+            
+            if(block < 254 || remaining == 0)
+                break;
+        }
+        
+        output.push_back(0);                                                                // frame delimiter
+    }
+    
+    
+    long slip_decode(uint8_t* data, size_t size)
+    {
+        size_t write_pos = 0;
+        
+        for(size_t read_pos = 0; read_pos < size; read_pos++)
+        {
+            uint8_t value = data[read_pos];
+            
+            if(value == SLIP_ESC)
+            {
+                if(++read_pos >= size)
+                    return -1;                                                              // escape at the end of the frame
+                
+                if(data[read_pos] == SLIP_ESC_END)
+                    value = SLIP_END;
+                else if(data[read_pos] == SLIP_ESC_ESC)
+                    value = SLIP_ESC;
+                else
+                    return -1;                                                              // invalid escape sequence
+            }
+            
+            data[write_pos++] = value;
+        }
+        
+        return write_pos;
+    }
+    
+    
+    void slip_encode(std::span<const uint8_t> payload, std::vector<uint8_t>& output)
+    {
+        reserve_append(output, 2 * payload.size() + 2);
+        output.push_back(SLIP_END);                                                         // flushes noise received before the frame
+        
+        for(uint8_t value : payload)
+        {
+            if(value == SLIP_END)
+            {
+                output.push_back(SLIP_ESC);
+                output.push_back(SLIP_ESC_END);
+            }
+            else if(value == SLIP_ESC)
+            {
+                output.push_back(SLIP_ESC);
+                output.push_back(SLIP_ESC_ESC);
+            }
+            else
+                output.push_back(value);
+        }
+        
+        output.push_back(SLIP_END);
+    }
+    
+    
+    FrameStream::FrameStream(Serial& serial, Framing framing) : FrameStream::FrameStream(serial, framing, FRAME_DEFAULT_MAX_SIZE) {}
+    
+    FrameStream::FrameStream(Serial& serial, Framing framing, size_t max_frame_size) : serial(serial), rx_buffer(2 * max_frame_size + FRAME_RX_CHUNK_SIZE)
+    {
+        if(framing == Framing::LENGTH_PREFIX && max_frame_size > FRAME_LENGTH_MAX)          // the length would be truncated on the wire
+            throw SerialError("Frame stream: Maximum frame size exceeds the 16 bit length prefix.");
+        
+        this->framing_stored = framing;
+        this->max_frame_size_stored = max_frame_size;
+        this->consumed = 0;
+        this->discard_flag = false;
+        this->dropped_frames = 0;
+        this->crc_stored = Crc::NONE;
+        this->crc_errors_stored = 0;
+    }
+    
+    
+    std::span<const uint8_t> FrameStream::read_frame(void)
+    {
+        float timeout = this->serial.timeout();
+        
+        if(timeout < 0.0)
+            return this->read_frame(std::chrono::nanoseconds(-1));
+        
+        return this->read_frame(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(timeout)));
+    }
+    
+    
+    std::span<const uint8_t> FrameStream::read_frame(std::chrono::nanoseconds timeout)
+    {
+        Deadline deadline = (timeout.count() < 0) ? Deadline::max() : std::chrono::steady_clock::now() + timeout;
+        
+        this->rx_buffer.consume(this->consumed);                                            // the previous frame is not used any more
+        this->consumed = 0;
+        
+        while(true)
+        {
+            std::span<const uint8_t> frame;
+            
+            if(this->next_frame(frame) == true)
+            {
+                if(crc_check(this->crc_stored, frame.data(), frame.size()) == true)         // checked in place, no copy
+                    return frame.first(frame.size() - crc_size(this->crc_stored));
+                
+                this->crc_errors_stored++;
+                this->dropped_frames++;
+                this->rx_buffer.consume(this->consumed);
+                this->consumed = 0;
+                continue;
+            }
+            
+            std::chrono::nanoseconds remaining(-1);
+            
+            if(deadline != Deadline::max())
+            {
+                remaining = deadline - std::chrono::steady_clock::now();
+                
+                if(remaining.count() < 0)
+                    remaining = std::chrono::nanoseconds(0);
+            }
+            
+            std::span<uint8_t> free_space = this->rx_buffer.prepare(FRAME_RX_CHUNK_SIZE);
+            this->rx_buffer.commit(this->serial.read_some(free_space, remaining));          // received data stays buffered on a timeout
+        }
+    }
+    
+    
+    void FrameStream::write_frame(std::span<const uint8_t> payload)
+    {
+        if(payload.size() > this->max_frame_size_stored)
+            throw SerialError("Frame stream write: Frame is too large.");
+        
+        uint8_t check_value[4];
+        size_t check_size = crc_size(this->crc_stored);
+        
+        crc_store(this->crc_stored, serial::crc(this->crc_stored, payload.data(), payload.size()), check_value);
+        
+        if(check_size > 0 && this->framing_stored != Framing::LENGTH_PREFIX)                // byte stuffing needs the check value behind the payload
+        {
+            this->crc_buffer.assign(payload.begin(), payload.end());
+            this->crc_buffer.insert(this->crc_buffer.end(), check_value, check_value + check_size);
+            payload = this->crc_buffer;
+        }
+        
+        switch(this->framing_stored)
+        {
+            case Framing::COBS :
+                this->tx_buffer.clear();
+                cobs_encode(payload, this->tx_buffer);
+                this->serial.write(this->tx_buffer);
+                break;
+            case Framing::SLIP :
+                this->tx_buffer.clear();
+                slip_encode(payload, this->tx_buffer);
+                this->serial.write(this->tx_buffer);
+                break;
+            case Framing::LENGTH_PREFIX :
+            {
+                size_t length = payload.size() + check_size;
+                uint8_t header[2] = {(uint8_t)(length >> 8), (uint8_t)length};
+                std::span<const uint8_t> buffers[3] = {header, payload, std::span<const uint8_t>(check_value, check_size)};
+                this->serial.write_batch(buffers);                                          // header, payload and check value with one writev call, no copy
+                break;
+            }
+        }
+    }
+    
+    
+    Framing FrameStream::framing(void)
+    {
+        return this->framing_stored;
+    }
+    
+    
+    size_t FrameStream::max_frame_size(void)
+    {
+        return this->max_frame_size_stored;
+    }
+    
+    
+    uint64_t FrameStream::dropped(void)
+    {
+        return this->dropped_frames;
+    }
+    
+    
+    Crc FrameStream::crc(void)
+    {
+        return this->crc_stored;
+    }
+    
+    
+    void FrameStream::crc(Crc type)
+    {
+        if(this->framing_stored == Framing::LENGTH_PREFIX && this->max_frame_size_stored + crc_size(type) > FRAME_LENGTH_MAX)   // the prefix counts the check value
+            throw SerialError("Frame stream: Maximum frame size and check value exceed the 16 bit length prefix.");
+        
+        this->crc_stored = type;
+    }
+    
+    
+    uint64_t FrameStream::crc_errors(void)
+    {
+        return this->crc_errors_stored;
+    }
+    
+    
+    size_t FrameStream::max_decoded_size(void)
+    {
+        return this->max_frame_size_stored + crc_size(this->crc_stored);
+    }
+    
+    
+    bool FrameStream::next_frame(std::span<const uint8_t>& frame)
+    {
+        switch(this->framing_stored)
+        {
+            case Framing::COBS :
+                return this->next_delimited_frame(0x00, frame);
+            case Framing::SLIP :
+                return this->next_delimited_frame(SLIP_END, frame);
+            default :
+                return this->next_length_prefix_frame(frame);
+        }
+    }
+    
+    
+    bool FrameStream::next_delimited_frame(uint8_t delimiter, std::span<const uint8_t>& frame)
+    {
+        size_t max_size = this->max_decoded_size();
+        size_t max_encoded_size = (this->framing_stored == Framing::COBS) ? max_size + max_size / 254 + 1 : 2 * max_size;
+        
+        while(this->rx_buffer.empty() == false)
+        {
+            uint8_t* data = this->rx_buffer.data();
+            const uint8_t* pos = find_byte(data, this->rx_buffer.size(), delimiter);
+            
+            if(pos == NULL)
+            {
+                if(this->rx_buffer.size() > max_encoded_size)                               // frame is too large, drop it up to the next delimiter
+                {
+                    if(this->discard_flag == false)
+                        this->dropped_frames++;
+                    
+                    this->discard_flag = true;
+                    this->rx_buffer.clear();
+                }
+                
+                return false;
+            }
+            
+            size_t length = pos - data;
+            
+            if(this->discard_flag == true || length == 0)                                   // rest of a dropped frame or empty frame
+            {
+                this->discard_flag = false;
+                this->rx_buffer.consume(length + 1);
+                continue;
+            }
+            
+            long size = (this->framing_stored == Framing::COBS) ? cobs_decode(data, length) : slip_decode(data, length);
+            
+            if(size < 0 || (size_t)size > max_size)
+            {
+                this->dropped_frames++;                                                     // corrupt frame, continue with the next one
+                this->rx_buffer.consume(length + 1);
+                continue;
+            }
+            
+            frame = std::span<const uint8_t>(data, size);
+            this->consumed = length + 1;
+            return true;
+        }
+        
+        return false;
+    }
+    
+    
+    bool FrameStream::next_length_prefix_frame(std::span<const uint8_t>& frame)
+    {
+        while(this->rx_buffer.size() >= 2)
+        {
+            const uint8_t* data = this->rx_buffer.data();
+            size_t length = ((size_t)data[0] << 8) | data[1];
+            
+            if(length > this->max_decoded_size())                                           // invalid header, search the next one byte by byte
+            {
+                if(this->discard_flag == false)
+                    this->dropped_frames++;
+                
+                this->discard_flag = true;
+                this->rx_buffer.consume(1);
+                continue;
+            }
+            
+            if(this->rx_buffer.size() < 2 + length)
+                return false;
+            
+            this->discard_flag = false;
+            frame = std::span<const uint8_t>(data + 2, length);
+            this->consumed = 2 + length;
+            return true;
+        }
+        
+        return false;
+    }
+}
+
+
+
@@ -0,0 +1,571 @@
+/**
+ * @file modbus.cpp
+ * @brief Modbus RTU master source file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ */
+
+
+#include <vector>
+#include <span>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+#include "modbus.hpp"
+#include "crc.hpp"
+
+
+#define MODBUS_RESPONSE_TIMEOUT                 1.0                                 // default response timeout in s
+#define MODBUS_CHARACTER_BITS                   10                                  // start bit, 8 data bits and stop bit
+#define MODBUS_GAP_BAUDRATE                     19200                               // above this baudrate the gap is fixed
+#define MODBUS_GAP_MIN                          1750000                             // gap in ns above MODBUS_GAP_BAUDRATE
+#define MODBUS_EXCEPTION_FLAG                   0x80                                // set in the function code of an exception response
+#define MODBUS_READ_HOLDING_REGISTERS           0x03
+#define MODBUS_READ_INPUT_REGISTERS             0x04
+#define MODBUS_WRITE_REGISTER                   0x06
+#define MODBUS_WRITE_REGISTERS                  0x10
+
+
+namespace serial
+{
+    static std::chrono::nanoseconds remaining(Deadline deadline)
+    {
+        std::chrono::nanoseconds time = deadline - std::chrono::steady_clock::now();
+        
+        return (time.count() < 0) ? std::chrono::nanoseconds(0) : time;                     // a negative timeout would block Serial forever
+    }
+    
+    
+    static void store_u16(uint8_t* output, uint16_t value)
+    {
+        output[0] = value >> 8;                                                             // Modbus data is big-endian
+        output[1] = value;
+    }
+    
+    
+    static uint16_t load_u16(const uint8_t* data)
+    {
+        return ((uint16_t)data[0] << 8) | data[1];
+    }
+    
+    
+    static ModbusStatus decode_registers(ModbusStatus status, const uint8_t* response, size_t response_size, std::span<uint16_t> registers)
+    {
+        if(status != ModbusStatus::OK)
+            return status;
+        if(response_size != 2 + 2 * registers.size() || response[1] != 2 * registers.size())
+            return ModbusStatus::INVALID_RESPONSE;
+        
+        for(size_t i = 0; i < registers.size(); i++)
+            registers[i] = load_u16(response + 2 + 2 * i);
+        
+        return ModbusStatus::OK;
+    }
+    
+    
+    std::chrono::nanoseconds modbus_gap(uint32_t baudrate)
+    {
+        if(baudrate == 0)
+            return std::chrono::nanoseconds(0);
+        if(baudrate > MODBUS_GAP_BAUDRATE)                                                  // a few character times are shorter than the delays of USB adapters
+            return std::chrono::nanoseconds(MODBUS_GAP_MIN);
+        
+        return std::chrono::nanoseconds((uint64_t)7 * MODBUS_CHARACTER_BITS * 1000000000 / (2 * (uint64_t)baudrate));   // 3.5 characters
+    }
+    
+    
+    size_t modbus_response_size(const uint8_t* response, size_t size)
+    {
+        if(size < 2)
+            return 0;
+        
+        if(response[1] & MODBUS_EXCEPTION_FLAG)                                             // slave, function, exception code and CRC
+            return 5;
+        
+        switch(response[1])
+        {
+            case 0x01 :                                                                     // reads, the byte count follows the function code
+            case 0x02 :
+            case 0x03 :
+            case 0x04 :
+                return (size < 3) ? 0 : 5 + response[2];
+            case 0x05 :                                                                     // writes, address and value or quantity are echoed
+            case 0x06 :
+            case 0x0F :
+            case 0x10 :
+                return 8;
+            default :
+                return 0;                                                                   // ended by the gap
+        }
+    }
+    
+    
+    ModbusMaster::ModbusMaster(Serial& serial) : serial(serial)
+    {
+        this->response_timeout_stored = MODBUS_RESPONSE_TIMEOUT;
+        this->gap_stored = std::chrono::nanoseconds(-1);
+        this->bus_idle = std::chrono::steady_clock::now();
+        this->resync_flag = true;                                                           // drop data received before the first request
+        this->exception_code_stored = 0;
+        this->stats_stored = ModbusStats();
+        this->tx_size = 0;
+        this->rx_size = 0;
+    }
+    
+    
+    ModbusStatus ModbusMaster::transact(uint8_t slave, std::span<const uint8_t> request, std::span<uint8_t> response, size_t& response_size)
+    {
+        response_size = 0;
+        ModbusStatus status = this->prepare(slave, request);
+        
+        if(status != ModbusStatus::OK)
+            return status;
+        
+        std::this_thread::sleep_until(this->bus_idle);                                      // silence between two frames on the bus
+        
+        try
+        {
+            this->serial.write(std::span<const uint8_t>(this->tx_frame.data(), this->tx_size));
+        }
+        catch(const SerialTimeoutException&)
+        {
+            return this->finish(ModbusStatus::TIMEOUT, std::chrono::steady_clock::now(), response, response_size);
+        }
+        catch(const std::exception&)
+        {
+            return this->finish(ModbusStatus::IO_ERROR, std::chrono::steady_clock::now(), response, response_size);
+        }
+        
+        Deadline last_received = std::chrono::steady_clock::now();
+        
+        if(slave == 0)                                                                      // broadcast, the slaves do not answer
+            return this->finish(ModbusStatus::OK, last_received, response, response_size);
+        
+        Deadline deadline = last_received + std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(this->response_timeout_stored));
+        std::chrono::nanoseconds gap = this->gap();
+        
+        while(true)
+        {
+            size_t expected = modbus_response_size(this->rx_frame.data(), this->rx_size);
+            bool gap_flag = (this->rx_size > 0 && expected == 0 && last_received + gap < deadline);   // only a frame of unknown length ends with the gap
+            Deadline wait_deadline = (gap_flag == true) ? last_received + gap : deadline;
+            size_t num;
+            
+            SerialStatus serial_status = this->serial.try_read_some(std::span<uint8_t>(this->rx_frame.data() + this->rx_size, MODBUS_ADU_SIZE - this->rx_size), num, remaining(wait_deadline));
+            
+            if(serial_status == SerialStatus::TIMEOUT)
+            {
+                this->stats_stored.gap_ends += (gap_flag == true);
+                status = (this->rx_size > 0 && expected == 0) ? ModbusStatus::OK : ModbusStatus::TIMEOUT;   // a response of known length is incomplete
+                break;
+            }
+            
+            if(serial_status != SerialStatus::OK)
+            {
+                status = ModbusStatus::IO_ERROR;
+                break;
+            }
+            
+            if(this->received(num, last_received) == true)
+                break;
+        }
+        
+        return this->finish(status, last_received, response, response_size);
+    }
+    
+    
+    Task<ModbusStatus> ModbusMaster::async_transact(EventLoop& loop, uint8_t slave, std::span<const uint8_t> request, std::span<uint8_t> response, size_t& response_size)
+    {
+        response_size = 0;
+        ModbusStatus status = this->prepare(slave, request);
+        
+        if(status != ModbusStatus::OK)
+            co_return status;
+        
+        if(std::chrono::steady_clock::now() < this->bus_idle)
+            co_await loop.sleep_until(this->bus_idle, NULL);
+        
+        try
+        {
+            co_await this->serial.async_write(loop, std::span<const uint8_t>(this->tx_frame.data(), this->tx_size));
+        }
+        catch(const SerialTimeoutException&)
+        {
+            status = ModbusStatus::TIMEOUT;
+        }
+        catch(const std::exception&)
+        {
+            status = ModbusStatus::IO_ERROR;
+        }
+        
+        Deadline last_received = std::chrono::steady_clock::now();
+        
+        if(status != ModbusStatus::OK || slave == 0)
+            co_return this->finish(status, last_received, response, response_size);
+        
+        Deadline deadline = last_received + std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(this->response_timeout_stored));
+        std::chrono::nanoseconds gap = this->gap();
+        
+        while(true)
+        {
+            size_t expected = modbus_response_size(this->rx_frame.data(), this->rx_size);
+            bool gap_flag = (this->rx_size > 0 && expected == 0 && last_received + gap < deadline);
+            Deadline wait_deadline = (gap_flag == true) ? last_received + gap : deadline;
+            size_t num;
+            
+            SerialStatus serial_status = co_await this->serial.async_try_read_some(loop, std::span<uint8_t>(this->rx_frame.data() + this->rx_size, MODBUS_ADU_SIZE - this->rx_size), num, remaining(wait_deadline));
+            
+            if(serial_status == SerialStatus::TIMEOUT)
+            {
+                this->stats_stored.gap_ends += (gap_flag == true);
+                status = (this->rx_size > 0 && expected == 0) ? ModbusStatus::OK : ModbusStatus::TIMEOUT;   // a response of known length is incomplete
+                break;
+            }
+            
+            if(serial_status != SerialStatus::OK)
+            {
+                status = ModbusStatus::IO_ERROR;
+                break;
+            }
+            
+            if(this->received(num, last_received) == true)
+                break;
+        }
+        
+        co_return this->finish(status, last_received, response, response_size);
+    }
+    
+    
+    ModbusStatus ModbusMaster::prepare(uint8_t slave, std::span<const uint8_t> request)
+    {
+        if(request.empty() == true || request.size() > MODBUS_PDU_SIZE || slave > 247)
+            return ModbusStatus::INVALID_ARGUMENT;
+        
+        if(this->resync_flag == true)                                                       // a late or corrupt response must not be taken for the next one
+        {
+            try
+            {
+                this->serial.reset_input_buffer();
+            }
+            catch(const std::exception&)
+            {
+                return ModbusStatus::IO_ERROR;
+            }
+            
+            this->resync_flag = false;
+        }
+        
+        this->tx_frame[0] = slave;
+        std::memcpy(this->tx_frame.data() + 1, request.data(), request.size());
+        crc_store(Crc::CRC16_MODBUS, crc(Crc::CRC16_MODBUS, this->tx_frame.data(), request.size() + 1), this->tx_frame.data() + request.size() + 1);
+        
+        this->tx_size = request.size() + 3;
+        this->rx_size = 0;
+        
+        return ModbusStatus::OK;
+    }
+    
+    
+    bool ModbusMaster::received(size_t num, Deadline& last_received)
+    {
+        this->rx_size += num;
+        last_received = std::chrono::steady_clock::now();
+        
+        size_t expected = modbus_response_size(this->rx_frame.data(), this->rx_size);
+        
+        return (expected > 0 && this->rx_size >= expected) || this->rx_size == MODBUS_ADU_SIZE;   // complete without waiting for the gap
+    }
+    
+    
+    ModbusStatus ModbusMaster::finish(ModbusStatus status, Deadline last_received, std::span<uint8_t> response, size_t& response_size)
+    {
+        if(status == ModbusStatus::OK && this->tx_frame[0] != 0)
+            status = this->check(response, response_size);
+        
+        this->bus_idle = last_received + this->gap();
+        this->stats_stored.transactions++;
+        
+        switch(status)
+        {
+            case ModbusStatus::OK :
+            case ModbusStatus::INVALID_ARGUMENT :
+                break;
+            case ModbusStatus::EXCEPTION :
+                this->stats_stored.exceptions++;
+                break;
+            case ModbusStatus::TIMEOUT :
+                this->stats_stored.timeouts++;
+                this->resync_flag = true;
+                break;
+            case ModbusStatus::CRC_ERROR :
+                this->stats_stored.crc_errors++;
+                this->resync_flag = true;
+                break;
+            default :
+                this->stats_stored.invalid_responses += (status == ModbusStatus::INVALID_RESPONSE);
+                this->resync_flag = true;
+                break;
+        }
+        
+        return status;
+    }
+    
+    
+    ModbusStatus ModbusMaster::check(std::span<uint8_t> response, size_t& response_size)
+    {
+        size_t expected = modbus_response_size(this->rx_frame.data(), this->rx_size);
+        size_t size = this->rx_size;
+        
+        if(expected > 0 && size > expected)                                                 // trailing bytes do not belong to the response
+        {
+            size = expected;
+            this->resync_flag = true;
+        }
+        
+        if(size < 4)
+            return ModbusStatus::INVALID_RESPONSE;
+        if(crc_check(Crc::CRC16_MODBUS, this->rx_frame.data(), size) == false)
+            return ModbusStatus::CRC_ERROR;
+        if(this->rx_frame[0] != this->tx_frame[0])
+            return ModbusStatus::INVALID_RESPONSE;
+        
+        if(this->rx_frame[1] == (this->tx_frame[1] | MODBUS_EXCEPTION_FLAG) && size == 5)
+        {
+            this->exception_code_stored = this->rx_frame[2];
+            return ModbusStatus::EXCEPTION;
+        }
+        
+        if(this->rx_frame[1] != this->tx_frame[1])
+            return ModbusStatus::INVALID_RESPONSE;
+        if(size - 3 > response.size())
+            return ModbusStatus::INVALID_ARGUMENT;
+        
+        response_size = size - 3;                                                           // without slave address and CRC
+        std::memcpy(response.data(), this->rx_frame.data() + 1, response_size);
+        
+        return ModbusStatus::OK;
+    }
+    
+    
+    ModbusStatus ModbusMaster::read_holding_registers(uint8_t slave, uint16_t address, std::span<uint16_t> registers)
+    {
+        if(registers.empty() == true || registers.size() > MODBUS_MAX_READ_REGISTERS)
+            return ModbusStatus::INVALID_ARGUMENT;
+        
+        uint8_t request[5] = {MODBUS_READ_HOLDING_REGISTERS};
+        uint8_t response[MODBUS_PDU_SIZE];
+        size_t response_size = 0;
+        
+        store_u16(request + 1, address);
+        store_u16(request + 3, registers.size());
+        
+        ModbusStatus status = this->transact(slave, request, response, response_size);
+        
+        return decode_registers(status, response, response_size, registers);
+    }
+    
+    
+    ModbusStatus ModbusMaster::read_input_registers(uint8_t slave, uint16_t address, std::span<uint16_t> registers)
+    {
+        if(registers.empty() == true || registers.size() > MODBUS_MAX_READ_REGISTERS)
+            return ModbusStatus::INVALID_ARGUMENT;
+        
+        uint8_t request[5] = {MODBUS_READ_INPUT_REGISTERS};
+        uint8_t response[MODBUS_PDU_SIZE];
+        size_t response_size = 0;
+        
+        store_u16(request + 1, address);
+        store_u16(request + 3, registers.size());
+        
+        ModbusStatus status = this->transact(slave, request, response, response_size);
+        
+        return decode_registers(status, response, response_size, registers);
+    }
+    
+    
+    ModbusStatus ModbusMaster::write_register(uint8_t slave, uint16_t address, uint16_t value)
+    {
+        uint8_t request[5] = {MODBUS_WRITE_REGISTER};
+        uint8_t response[MODBUS_PDU_SIZE];
+        size_t response_size = 0;
+        
+        store_u16(request + 1, address);
+        store_u16(request + 3, value);
+        
+        ModbusStatus status = this->transact(slave, request, response, response_size);
+        
+        if(status == ModbusStatus::OK && slave != 0 && (response_size != 5 || std::memcmp(request, response, 5) != 0))
+            return ModbusStatus::INVALID_RESPONSE;                                          // the request is echoed
+        
+        return status;
+    }
+    
+    
+    ModbusStatus ModbusMaster::write_registers(uint8_t slave, uint16_t address, std::span<const uint16_t> registers)
+    {
+        if(registers.empty() == true || registers.size() > MODBUS_MAX_WRITE_REGISTERS)
+            return ModbusStatus::INVALID_ARGUMENT;
+        
+        uint8_t request[MODBUS_PDU_SIZE] = {MODBUS_WRITE_REGISTERS};
+        uint8_t response[MODBUS_PDU_SIZE];
+        size_t response_size = 0;
+        
+        store_u16(request + 1, address);
+        store_u16(request + 3, registers.size());
+        request[5] = 2 * registers.size();
+        
+        for(size_t i = 0; i < registers.size(); i++)
+            store_u16(request + 6 + 2 * i, registers[i]);
+        
+        ModbusStatus status = this->transact(slave, std::span<const uint8_t>(request, 6 + 2 * registers.size()), response, response_size);
+        
+        if(status == ModbusStatus::OK && slave != 0 && (response_size != 5 || std::memcmp(request, response, 5) != 0))
+            return ModbusStatus::INVALID_RESPONSE;                                          // address and quantity are echoed
+        
+        return status;
+    }
+    
+    
+    Task<ModbusStatus> ModbusMaster::async_read_registers(EventLoop& loop, uint8_t slave, uint8_t function, uint16_t address, std::span<uint16_t> registers)
+    {
+        if(registers.empty() == true || registers.size() > MODBUS_MAX_READ_REGISTERS)
+            co_return ModbusStatus::INVALID_ARGUMENT;
+        if(function != MODBUS_READ_HOLDING_REGISTERS && function != MODBUS_READ_INPUT_REGISTERS)
+            co_return ModbusStatus::INVALID_ARGUMENT;
+        
+        uint8_t request[5] = {function};
+        uint8_t response[MODBUS_PDU_SIZE];
+        size_t response_size = 0;
+        
+        store_u16(request + 1, address);
+        store_u16(request + 3, registers.size());
+        
+        ModbusStatus status = co_await this->async_transact(loop, slave, request, response, response_size);
+        
+        co_return decode_registers(status, response, response_size, registers);
+    }
+    
+    
+    uint8_t ModbusMaster::exception_code(void)
+    {
+        return this->exception_code_stored;
+    }
+    
+    
+    float ModbusMaster::response_timeout(void)
+    {
+        return this->response_timeout_stored;
+    }
+    
+    
+    void ModbusMaster::response_timeout(float new_timeout)
+    {
+        this->response_timeout_stored = new_timeout;
+    }
+    
+    
+    std::chrono::nanoseconds ModbusMaster::gap(void)
+    {
+        if(this->gap_stored.count() < 0)
+            return modbus_gap(this->serial.baudrate());
+        
+        return this->gap_stored;
+    }
+    
+    
+    void ModbusMaster::gap(std::chrono::nanoseconds new_gap)
+    {
+        this->gap_stored = new_gap;
+    }
+    
+    
+    ModbusStats ModbusMaster::stats(void)
+    {
+        return this->stats_stored;
+    }
+    
+    
+    Serial& ModbusMaster::port(void)
+    {
+        return this->serial;
+    }
+    
+    
+    ModbusPoller::ModbusPoller()
+    {
+    }
+    
+    
+    size_t ModbusPoller::add(ModbusMaster& master, uint8_t slave, uint8_t function, uint16_t address, uint16_t count)
+    {
+        if(count == 0 || count > MODBUS_MAX_READ_REGISTERS || (function != MODBUS_READ_HOLDING_REGISTERS && function != MODBUS_READ_INPUT_REGISTERS))
+            throw SerialError("Modbus poller add: Invalid register range.");
+        
+        ModbusPoll poll;
+        poll.master = &master;
+        poll.slave = slave;
+        poll.function = function;
+        poll.address = address;
+        poll.registers.assign(count, 0);
+        poll.status = ModbusStatus::TIMEOUT;                                                // not polled yet
+        this->polls.push_back(std::move(poll));
+        
+        auto bus = std::find(this->buses.begin(), this->buses.end(), &master);
+        
+        if(bus == this->buses.end())
+        {
+            this->buses.push_back(&master);
+            this->bus_polls.emplace_back();
+            bus = this->buses.end() - 1;
+        }
+        
+        this->bus_polls[bus - this->buses.begin()].push_back(this->polls.size() - 1);
+        
+        return this->polls.size() - 1;
+    }
+    
+    
+    ModbusPoll& ModbusPoller::poll(size_t index)
+    {
+        return this->polls.at(index);
+    }
+    
+    
+    size_t ModbusPoller::size(void)
+    {
+        return this->polls.size();
+    }
+    
+    
+    size_t ModbusPoller::run_cycle(void)
+    {
+        for(size_t bus = 0; bus < this->buses.size(); bus++)                                // one task per bus, all of them wait concurrently
+            this->loop.spawn(this->poll_bus(bus));
+        
+        this->loop.run();
+        
+        size_t successful = 0;
+        
+        for(const ModbusPoll& poll : this->polls)
+            successful += (poll.status == ModbusStatus::OK);
+        
+        return successful;
+    }
+    
+    
+    Task<void> ModbusPoller::poll_bus(size_t bus)
+    {
+        for(size_t index : this->bus_polls[bus])
+        {
+            ModbusPoll& poll = this->polls[index];
+            poll.status = co_await poll.master->async_read_registers(this->loop, poll.slave, poll.function, poll.address, poll.registers);
+        }
+    }
+}
+
+
+
@@ -0,0 +1,120 @@
+/**
+ * @file rx_buffer.cpp
+ * @brief Receive buffer source file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ */
+
+
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "rx_buffer.hpp"
+
+
+namespace serial
+{
+    RxBuffer::RxBuffer(size_t capacity) : storage(capacity)
+    {
+        this->head = 0;
+        this->tail = 0;
+    }
+    
+    
+    const uint8_t* RxBuffer::data(void) const
+    {
+        return this->storage.data() + this->head;
+    }
+    
+    
+    uint8_t* RxBuffer::data(void)
+    {
+        return this->storage.data() + this->head;
+    }
+    
+    
+    size_t RxBuffer::size(void) const
+    {
+        return this->tail - this->head;
+    }
+    
+    
+    bool RxBuffer::empty(void) const
+    {
+        return this->tail == this->head;
+    }
+    
+    
+    void RxBuffer::consume(size_t size)
+    {
+        if(size >= this->size())
+            this->clear();
+        else
+            this->head += size;
+    }
+    
+    
+    size_t RxBuffer::read(uint8_t* buffer, size_t size)
+    {
+        if(size > this->size())
+            size = this->size();
+        
+        std::memcpy(buffer, this->data(), size);
+        this->consume(size);
+        
+        return size;
+    }
+    
+    
+    void RxBuffer::clear(void)
+    {
+        this->head = 0;
+        this->tail = 0;
+    }
+    
+    
+    std::span<uint8_t> RxBuffer::prepare(size_t min_size)
+    {
+        if(this->storage.size() - this->tail < min_size)
+        {
+            size_t num = this->size();
+            
+            if(this->head > 0)                                                              // move readable data to the front
+            {
+                std::memmove(this->storage.data(), this->storage.data() + this->head, num);
+                this->head = 0;
+                this->tail = num;
+            }
+            
+            if(this->storage.size() - this->tail < min_size)                                // still not enough space, grow the storage
+            {
+                size_t new_size = this->storage.size() * 2;
+                
+                if(new_size < num + min_size)
+                    new_size = num + min_size;
+                
+                this->storage.resize(new_size);
+            }
+        }
+        
+        return std::span<uint8_t>(this->storage.data() + this->tail, this->storage.size() - this->tail);
+    }
+    
+    
+    void RxBuffer::commit(size_t size)
+    {
+        this->tail += size;
+    }
+    
+    
+    size_t RxBuffer::capacity(void) const
+    {
+        return this->storage.size();
+    }
+}
+
+
+
@@ -9,30 +9,189 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <span>
 #include <cstdint>
+#include <cstring>
+#include <cerrno>
 #include <stdexcept>
 #include <chrono>
 #include <thread>
+#include <fstream>
+#include <filesystem>
 
-#include <termios.h>
 #include <unistd.h>
-#include <sys/file.h>
+#include <pthread.h>
+#include <sched.h>
 #include <sys/ioctl.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <poll.h>
+#include <linux/futex.h>
+#include <linux/serial.h>
 
 #include "serial.hpp"
+#include "byte_search.hpp"
 
 
-#define SERIAL_RX_LINE_BUFFER_SIZE              256
+#define SERIAL_RX_BUFFER_SIZE                   4096                                // initial size of the receive buffer
+#define SERIAL_RX_CHUNK_SIZE                    1024                                // minimum free space for one read call
+#define SERIAL_TX_THRESHOLD                     1024                                // default size at which queued data is sent
+#define SERIAL_TX_IOV_SIZE                      64                                  // buffers per writev call
+#define SERIAL_TX_PENDING                       0                                   // states of a message in the transmit queue
+#define SERIAL_TX_WAITING                       1                                   // the writing thread sleeps on the futex
+#define SERIAL_TX_DONE                          2
+#define SERIAL_TX_HANDOFF                       3                                   // an async write passed the queue to the waiting thread
+#define SERIAL_TX_WAKE_SIZE                     64                                  // sleeping threads woken after the queue is released
+#define SERIAL_LATENCY_TIMER_LOW                1                                   // latency timer of USB adapters in low latency mode in ms
+#define SERIAL_URING_ENTRIES                    4                                   // poll, transfer and cancel of one operation
+#define SERIAL_URING_POLL                       1                                   // user data of the submitted entries
+#define SERIAL_URING_TRANSFER                   2
+#define SERIAL_URING_CANCEL                     3
+#define SERIAL_SETTLE_TIME                      0.01                                // default settle time after the settings are applied in s
+#define SERIAL_SETTLE_QUIET_LIMIT               1000                                // maximum wait for a quiet line in ms
+#define SERIAL_OPEN_THREADS                     16                                  // default threads of open_all
+#define SERIAL_READER_RING_SIZE                 (1024 * 1024)                       // buffer of the reader thread, about 10 s at 1 MBd
 
 
 namespace serial
 {
-    Serial::Serial(std::string port, uint32_t baudrate, float timeout)
+    static std::chrono::nanoseconds seconds_to_duration(float timeout)
+    {
+        if(timeout < 0.0)
+            return std::chrono::nanoseconds(-1);                                            // no timeout
+        
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(timeout));
+    }
+    
+    
+    static Deadline deadline_from(std::chrono::nanoseconds timeout)
+    {
+        if(timeout.count() < 0)
+            return Deadline::max();                                                         // no timeout, block until data is received
+        
+        return std::chrono::steady_clock::now() + timeout;
+    }
+    
+    
+    static struct timespec* remaining_time(Deadline deadline, struct timespec* timeout_struct)
+    {
+        if(deadline == Deadline::max())
+            return NULL;
+        
+        std::chrono::nanoseconds remaining = deadline - std::chrono::steady_clock::now();
+        
+        if(remaining.count() < 0)
+            remaining = std::chrono::nanoseconds(0);
+        
+        timeout_struct->tv_sec = remaining.count() / 1000000000LL;
+        timeout_struct->tv_nsec = remaining.count() % 1000000000LL;
+        
+        return timeout_struct;
+    }
+    
+    
+    static uint64_t elapsed_ns(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+    
+    
+    static void check_wait(WaitResult result, const char* function)
+    {
+        if(result == WaitResult::TIMEOUT)
+            throw SerialTimeoutException(std::string(function) + ": Timeout occured");
+        if(result == WaitResult::CANCELLED)
+            throw SerialCancelledException(std::string(function) + ": Operation cancelled");
+    }
+    
+    
+    static void throw_status(SerialStatus status, const char* function)
+    {
+        switch(status)
+        {
+            case SerialStatus::OK:
+                return;
+            case SerialStatus::TIMEOUT:
+                throw SerialTimeoutException(std::string(function) + ": Timeout occured");  // received data stays buffered
+            case SerialStatus::CLOSED:
+                throw SerialError(std::string(function) + ": Serial is closed.");
+            case SerialStatus::CALLBACK:
+                throw SerialError(std::string(function) + ": Received data is delivered by callback.");
+            case SerialStatus::INVALID_ARGUMENT:
+                throw SerialError(std::string(function) + ": Invalid argument.");
+            default:
+                throw SerialError(std::string(function) + ": Unable to read data on serialport.");
+        }
+    }
+    
+    
+    static void read_icount(int fd, SerialStats& stats)
+    {
+        struct serial_icounter_struct icount;
+        
+        stats.icount_valid = (fd >= 0 && ioctl(fd, TIOCGICOUNT, &icount) == 0);             // not supported by every driver, e.g. pty
+        stats.frame_errors = stats.icount_valid ? icount.frame : 0;
+        stats.parity_errors = stats.icount_valid ? icount.parity : 0;
+        stats.overruns = stats.icount_valid ? icount.overrun : 0;
+        stats.buffer_overruns = stats.icount_valid ? icount.buf_overrun : 0;
+        stats.breaks = stats.icount_valid ? icount.brk : 0;
+    }
+    
+    
+    static bool tune_thread(int cpu, int priority)
+    {
+        if(cpu >= 0)
+        {
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            CPU_SET(cpu, &cpu_set);
+            
+            if(pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0)
+                return false;
+        }
+        
+        if(priority > 0)                                                                    // needs CAP_SYS_NICE or an RLIMIT_RTPRIO
+        {
+            struct sched_param param;
+            param.sched_priority = priority;
+            
+            if(pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0)
+                return false;
+        }
+        
+        return true;
+    }
+    
+    
+    Serial::Serial(std::string port, uint32_t baudrate, float timeout) : terminator_stored("\n"), rx_buffer(SERIAL_RX_BUFFER_SIZE)
     {
         this->port_stored = port;
         this->baudrate_stored = baudrate;
         this->timeout_stored = timeout;
+        this->write_timeout_stored = -1.0;
+        this->inter_byte_timeout_stored = -1.0;
+        this->tx_threshold_stored = SERIAL_TX_THRESHOLD;
         this->open_flag = false;
+        this->reader_error = false;
+        this->tx_active = false;
+        this->tx_pending = NULL;
+        this->tx_pending_last = NULL;
+        this->tx_driver = NULL;
+        this->tx_reschedule = false;
+        this->reader_callback_flag = false;
+        this->reader_wake_fd = -1;
+        this->backend_stored = Backend::POSIX;
+        this->settle_policy_stored = SettlePolicy::FIXED;
+        this->settle_time_stored = SERIAL_SETTLE_TIME;
+        this->busy_poll_stored = 0.0;
+        this->busy_poll_cpu_stored = -1;
+        this->busy_poll_priority_stored = 0;
+        this->low_latency_saved = false;
+        this->async_low_latency_saved = false;
+        this->latency_timer_saved = -1;
+        this->capture_channel = 0;
+        this->transport_stored = std::make_shared<TtyTransport>();
     }
     
     Serial::Serial() : Serial::Serial("/dev/ttyUSB0", 9600, 1.0) {}
@@ -54,281 +213,2187 @@ namespace serial
     {
         if(this->open_flag == false)
         {
-            this->serial_fd = ::open(this->port_stored.c_str(), O_RDWR | O_NOCTTY | O_NDELAY);
-            
-            if(this->serial_fd < 0)
-                throw SerialError("Serial open: Unable to open serialport.");
-            
-            if(flock(this->serial_fd, LOCK_EX | LOCK_NB) < 0)
-                throw SerialError("Serial open: Serial port is already locked by another process.");
+            this->configure();
+            this->settle();
+        }
+        else
+        {
+            throw SerialError("Serial open: Serial is already open.");
+        }
+    }
+    
+    
+    std::vector<OpenResult> Serial::open_all(std::span<Serial* const> ports)
+    {
+        return open_all(ports, SERIAL_OPEN_THREADS);
+    }
+    
+    
+    std::vector<OpenResult> Serial::open_all(std::span<Serial* const> ports, unsigned threads)
+    {
+        std::vector<OpenResult> results(ports.size());
+        
+        for(size_t i = 0; i < ports.size(); i++)
+        {
+            results[i].serial = ports[i];
+            results[i].success = false;
+        }
+        
+        auto run_parallel = [&](void (Serial::*phase)(void), bool first) {
+            std::atomic<size_t> next(0);
+            auto worker = [&]() {
+                for(size_t i = next++; i < ports.size(); i = next++)                        // ports are taken one by one, a slow port does not stall the others
+                {
+                    if(first == false && results[i].success == false)
+                        continue;
+                    
+                    try
+                    {
+                        if(first == true && ports[i]->open_flag == true)
+                            throw SerialError("Serial open: Serial is already open.");
+                        
+                        (ports[i]->*phase)();
+                        results[i].success = true;
+                    }
+                    catch(const std::exception& e)
+                    {
+                        results[i].success = false;
+                        results[i].error = e.what();
+                    }
+                }
+            };
             
-            this->open_flag = true;
+            std::vector<std::thread> workers;
+            size_t count = (threads < ports.size()) ? threads : ports.size();
             
+            for(size_t i = 1; i < count; i++)                                               // the calling thread is one of the workers
+                workers.push_back(std::thread(worker));
             
-            struct termios port_settings;
+            worker();
             
-            if(tcgetattr(this->serial_fd, &port_settings) != 0)                             // read existing settings
-                throw SerialError("Serial open: Failed to read existing port settings.");
+            for(size_t i = 0; i < workers.size(); i++)
+                workers[i].join();
+        };
+        
+        run_parallel(&Serial::configure, true);                                             // the settle times of all ports overlap
+        run_parallel(&Serial::settle, false);
+        
+        return results;
+    }
+    
+    
+    void Serial::configure(void)
+    {
+        this->serial_fd = this->transport_stored->open(this->port_stored, this->baudrate_stored);
+        this->open_flag = true;
+        this->configured_time = std::chrono::steady_clock::now();
+    }
+    
+    
+    void Serial::settle(void)
+    {
+        try
+        {
+            Deadline settle_end = this->configured_time + seconds_to_duration(this->settle_time_stored);
             
-            port_settings.c_cflag = CS8 | CLOCAL | CREAD;
-            port_settings.c_iflag = 0;
-            port_settings.c_oflag = 0;
-            port_settings.c_lflag = 0;
-            port_settings.c_cc[VMIN] = 0;
-            port_settings.c_cc[VTIME] = 0;
+            if(this->settle_policy_stored == SettlePolicy::FIXED)
+                std::this_thread::sleep_until(settle_end);                                  // wait necessary for buffer flush, only the remaining time
             
+            if(this->transport_stored->flush(true, true) == false)
+                throw SerialError("Serial open: Unable to flush.");
             
-            speed_t baudrate_termios = B0;
+            if(this->settle_policy_stored == SettlePolicy::QUIET)
+            {
+                Deadline limit = this->configured_time + std::chrono::milliseconds(SERIAL_SETTLE_QUIET_LIMIT);
+                
+                while(std::chrono::steady_clock::now() < limit)                             // discard data until the line is quiet for the settle time
+                {
+                    SerialStatus status = this->wait_port(POLLIN, std::chrono::steady_clock::now() + seconds_to_duration(this->settle_time_stored));
+                    
+                    if(status == SerialStatus::TIMEOUT)
+                        break;
+                    if(status != SerialStatus::OK || this->transport_stored->flush(true, false) == false)
+                        throw SerialError("Serial open: Unable to flush.");
+                }
+            }
+        }
+        catch(...)
+        {
+            this->abort_open();
+            throw;
+        }
+        
+        this->rx_buffer.clear();
+        this->stats_recorder.reset();
+        
+        if(this->backend_stored == Backend::IO_URING && this->transport_stored->direct_io() == true)
+        {
+            this->uring = std::make_unique<IoUring>();
+            this->tx_uring = std::make_unique<IoUring>();
             
-            switch(this->baudrate_stored)
+            if(this->uring->setup(SERIAL_URING_ENTRIES) == false || this->uring->register_file(this->serial_fd) == false ||
+               this->tx_uring->setup(SERIAL_URING_ENTRIES) == false || this->tx_uring->register_file(this->serial_fd) == false)
             {
-                case 9600UL :
-                    baudrate_termios = B9600;
-                    break;
-                case 19200UL :
-                    baudrate_termios = B19200;
-                    break;
-                case 38400UL :
-                    baudrate_termios = B38400;
-                    break;
-                case 57600UL :
-                    baudrate_termios = B57600;
-                    break;
-                case 115200UL :
-                    baudrate_termios = B115200;
-                    break;
-                case 1000000UL :
-                    baudrate_termios = B1000000;
-                    break;
-                default :
-                    throw SerialError("Serial open: Baudrate is not supported.");
+                this->uring.reset();                                                        // not available, use the POSIX backend
+                this->tx_uring.reset();
             }
+        }
+    }
+    
+    
+    void Serial::abort_open(void)
+    {
+        this->transport_stored->close();
+        this->open_flag = false;
+    }
+    
+    
+    void Serial::close(void)
+    {
+        if(this->open_flag == true)
+        {
+            if(this->reader_ring != NULL)
+                this->stop_reader();
             
-            if(cfsetispeed(&port_settings, baudrate_termios) != 0)
-                throw SerialError("Serial open: Failed to set port speed.");
-            if(cfsetospeed(&port_settings, baudrate_termios) != 0)
-                throw SerialError("Serial open: Failed to set port speed.");
+            if(this->tx_buffer.empty() == false || this->tx_pending != NULL)                // also the rest of an abandoned async write
+                this->flush();
             
+            if(this->event_loop != NULL && *this->event_loop != NULL)                       // resumes waiting operations, which then fail
+                (*this->event_loop)->remove(this->serial_fd);
             
-            if(tcsetattr(this->serial_fd, TCSANOW, &port_settings) != 0)                    // save serial settings
-                throw SerialError("Serial open: Failed to set port settings.");
+            this->event_loop.reset();
+            this->uring.reset();
+            this->tx_uring.reset();
             
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));                     // wait necessary for buffer flush
+            if(this->transport_stored->close() == false)
+                throw SerialError("Serial close: Unable to close serialport.");
             
-            if(tcflush(this->serial_fd, TCIOFLUSH) != 0)
-                throw SerialError("Serial open: Unable to flush.");
+            this->open_flag = false;
         }
         else
         {
-            throw SerialError("Serial open: Serial is already open.");
+            throw SerialError("Serial close: Serial is already closed.");
         }
     }
     
     
-    void Serial::close(void)
+    uint32_t Serial::write(std::string_view data)
+    {
+        return this->write(std::span<const uint8_t>((const uint8_t*)data.data(), data.size()));
+    }
+    
+    
+    uint32_t Serial::write(std::span<const uint8_t> data)
     {
         if(this->open_flag == true)
         {
-            if(this->serial_fd < 0)
-                throw SerialError("Serial close: Unable to close serialport.");
-            if(flock(this->serial_fd, LOCK_UN) < 0)
-                throw SerialError("Serial close: Unable to close serialport.");
-            if(::close(this->serial_fd) < 0)
-                throw SerialError("Serial close: Unable to close serialport.");
+            struct iovec iov;
+            iov.iov_base = (void*)data.data();
+            iov.iov_len = data.size();
             
-            this->open_flag = false;
+            TxMessage message;
+            message.iov = &iov;
+            message.count = 1;
+            message.queued = false;
+            
+            this->transmit(message);                                                        // queued data is sent first, in the same system call
+            return data.size();
         }
         else
         {
-            throw SerialError("Serial close: Serial is already closed.");
+            throw SerialError("Serial write: Serial is closed.");
         }
     }
     
     
-    uint32_t Serial::write(std::string data)
+    size_t Serial::write_batch(std::span<const std::span<const uint8_t>> buffers)
     {
-        uint32_t return_num = 0;
-        
         if(this->open_flag == true)
         {
-            int num = ::write(this->serial_fd, data.c_str(), data.length());
+            struct iovec iov_array[SERIAL_TX_IOV_SIZE];
+            std::vector<struct iovec> iov_vector;
+            struct iovec* iov = iov_array;
+            size_t num = 0;
             
-            if(num < 0)
-                throw SerialError("Serial write: Unable to write data on serialport.");
-            else
-                return_num = num;
+            if(buffers.size() > SERIAL_TX_IOV_SIZE)                                         // the batch is one message, so it is never interleaved
+            {
+                iov_vector.resize(buffers.size());
+                iov = iov_vector.data();
+            }
+            
+            for(size_t i = 0; i < buffers.size(); i++)
+            {
+                iov[i].iov_base = (void*)buffers[i].data();
+                iov[i].iov_len = buffers[i].size();
+                num += buffers[i].size();
+            }
+            
+            TxMessage message;
+            message.iov = iov;
+            message.count = buffers.size();
+            message.queued = false;
+            
+            this->transmit(message);
+            return num;
         }
         else
         {
             throw SerialError("Serial write: Serial is closed.");
         }
-        
-        return return_num;
     }
     
     
-    uint32_t Serial::write(std::vector<uint8_t> data)
+    size_t Serial::write_batch(std::span<const std::string_view> buffers)
     {
-        uint32_t return_num = 0;
-        
         if(this->open_flag == true)
         {
-            int num = ::write(this->serial_fd, &data[0], data.size());
+            struct iovec iov_array[SERIAL_TX_IOV_SIZE];
+            std::vector<struct iovec> iov_vector;
+            struct iovec* iov = iov_array;
+            size_t num = 0;
             
-            if(num < 0)
-                throw SerialError("Serial write: Unable to write data on serialport.");
-            else
-                return_num = num;
+            if(buffers.size() > SERIAL_TX_IOV_SIZE)                                         // the batch is one message, so it is never interleaved
+            {
+                iov_vector.resize(buffers.size());
+                iov = iov_vector.data();
+            }
+            
+            for(size_t i = 0; i < buffers.size(); i++)
+            {
+                iov[i].iov_base = (void*)buffers[i].data();
+                iov[i].iov_len = buffers[i].size();
+                num += buffers[i].size();
+            }
+            
+            TxMessage message;
+            message.iov = iov;
+            message.count = buffers.size();
+            message.queued = false;
+            
+            this->transmit(message);
+            return num;
         }
         else
         {
             throw SerialError("Serial write: Serial is closed.");
         }
+    }
+    
+    
+    void Serial::queue_write(std::string_view data)
+    {
+        this->queue_write(std::span<const uint8_t>((const uint8_t*)data.data(), data.size()));
+    }
+    
+    
+    void Serial::queue_write(std::span<const uint8_t> data)
+    {
+        if(this->open_flag == true)
+        {
+            struct iovec iov;
+            iov.iov_base = (void*)data.data();
+            iov.iov_len = data.size();
+            
+            TxMessage message;
+            message.iov = &iov;
+            message.count = 1;
+            message.queued = true;
+            
+            this->transmit(message);                                                        // only the writing thread draining the queue changes tx_buffer
+        }
+        else
+        {
+            throw SerialError("Serial queue write: Serial is closed.");
+        }
+    }
+    
+    
+    void Serial::flush(void)
+    {
+        if(this->open_flag == true)
+        {
+            TxMessage message;                                                              // empty message, sends the queued data
+            message.iov = NULL;
+            message.count = 0;
+            message.queued = false;
+            
+            this->transmit(message);
+        }
+        else
+        {
+            throw SerialError("Serial flush: Serial is closed.");
+        }
+    }
+    
+    
+    void Serial::transmit(TxMessage& message)
+    {
+        message.deadline = deadline_from(seconds_to_duration(this->write_timeout_stored));
+        message.sent = 0;
+        message.error = NULL;
+        message.notify_fd = -1;
+        message.state.store(SERIAL_TX_PENDING, std::memory_order_relaxed);
+        this->tx_queue.push(&message);
+        
+        while(message.state.load(std::memory_order_acquire) != SERIAL_TX_DONE)
+        {
+            bool owner;
+            
+            if(message.state.load(std::memory_order_acquire) == SERIAL_TX_HANDOFF)          // the port is full and only async writes waited for it
+            {
+                message.state.store(SERIAL_TX_PENDING, std::memory_order_relaxed);
+                owner = true;
+            }
+            else
+            {
+                owner = (this->tx_active.exchange(true, std::memory_order_seq_cst) == false);
+            }
+            
+            if(owner == true)                                                               // no other thread writes, send the queued messages in this one
+            {
+                do
+                {
+                    std::atomic<uint32_t>* waiting[SERIAL_TX_WAKE_SIZE];
+                    int count = 0;
+                    
+                    this->tx_reschedule.store(false, std::memory_order_seq_cst);
+                    
+                    try
+                    {
+                        this->collect_tx();
+                        this->send_pending(true, waiting, count);
+                    }
+                    catch(...)
+                    {
+                        this->fail_pending(std::current_exception(), waiting, count);       // no message is left in a queue which nobody sends
+                    }
+                    
+                    this->tx_driver = NULL;
+                    this->tx_active.store(false, std::memory_order_seq_cst);
+                    
+                    for(int i = 0; i < count; i++)                                          // woken threads find the queue free and need not sleep again
+                        syscall(SYS_futex, waiting[i], FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+                }
+                while((this->tx_queue.empty() == false || this->tx_reschedule.load(std::memory_order_seq_cst) == true) && this->tx_active.exchange(true, std::memory_order_seq_cst) == false);
+            }
+            else                                                                            // the writing thread sends this message and wakes this thread
+            {
+                uint32_t expected = SERIAL_TX_PENDING;
+                message.state.compare_exchange_strong(expected, SERIAL_TX_WAITING, std::memory_order_acquire);
+                syscall(SYS_futex, &message.state, FUTEX_WAIT_PRIVATE, SERIAL_TX_WAITING, NULL, NULL, 0);
+            }
+        }
         
-        return return_num;
+        if(message.error)
+            std::rethrow_exception(message.error);
     }
     
     
-    std::string Serial::readline(void)
+    void Serial::collect_tx(void)
+    {
+        TxMessage* message = this->tx_queue.take_all();
+        
+        if(message == NULL)
+            return;
+        
+        if(this->tx_pending == NULL)                                                        // behind the messages which wait for the port
+            this->tx_pending = message;
+        else
+            this->tx_pending_last->next = message;
+        
+        while(message->next != NULL)
+            message = message->next;
+        
+        this->tx_pending_last = message;
+    }
+    
+    
+    bool Serial::send_pending(bool blocking, std::atomic<uint32_t>** waiting, int& count)
+    {
+        struct iovec iov[SERIAL_TX_IOV_SIZE];
+        auto start = std::chrono::steady_clock::now();
+        
+        while(this->tx_pending != NULL)
+        {
+            TxMessage* message = this->tx_pending;
+            
+            if(message->notify_fd >= 0 && static_cast<TxAsyncMessage*>(message)->abandoned.load() == true)
+            {
+                this->complete_tx(NULL, waiting, count);                                    // the task is gone, the rest is dropped like after a timeout
+                continue;
+            }
+            
+            if(message->queued == true)
+            {
+                for(int i = 0; i < message->count; i++)
+                    this->tx_buffer.insert(this->tx_buffer.end(), (const uint8_t*)message->iov[i].iov_base, (const uint8_t*)message->iov[i].iov_base + message->iov[i].iov_len);
+                
+                if(this->tx_buffer.size() < this->tx_threshold_stored)
+                {
+                    this->complete_tx(NULL, waiting, count);
+                    continue;
+                }
+                
+                message->queued = false;                                                    // enough data collected for one write call, done once it is sent
+                message->count = 0;
+            }
+            
+            int num_iov = 0;
+            size_t total = 0;
+            size_t skip = message->sent;
+            
+            if(this->tx_buffer.empty() == false)                                            // queued data first, in the same system call
+            {
+                iov[num_iov].iov_base = this->tx_buffer.data();
+                iov[num_iov].iov_len = this->tx_buffer.size();
+                total += iov[num_iov].iov_len;
+                num_iov++;
+            }
+            
+            for(TxMessage* batch = message; batch != NULL && batch->queued == false && num_iov < SERIAL_TX_IOV_SIZE; batch = batch->next)
+            {
+                if(batch->notify_fd >= 0 && static_cast<TxAsyncMessage*>(batch)->abandoned.load() == true)
+                    break;                                                                  // dropped once it is the first one
+                
+                for(int i = 0; i < batch->count && num_iov < SERIAL_TX_IOV_SIZE; i++)       // messages of other threads in the same system call
+                {
+                    if(skip >= batch->iov[i].iov_len)                                       // written before the port was full
+                    {
+                        skip -= batch->iov[i].iov_len;
+                        continue;
+                    }
+                    
+                    iov[num_iov].iov_base = (uint8_t*)batch->iov[i].iov_base + skip;
+                    iov[num_iov].iov_len = batch->iov[i].iov_len - skip;
+                    total += iov[num_iov].iov_len;
+                    skip = 0;
+                    num_iov++;
+                }
+            }
+            
+            if(total == 0)                                                                  // empty messages of flush
+            {
+                this->consume_tx(0, waiting, count);
+                continue;
+            }
+            
+            ssize_t num;
+            
+            if(blocking == true && this->tx_uring != NULL)                                  // wait until writable and write with one system call
+                num = this->uring_transfer(POLLOUT, iov, num_iov, message->deadline);
+            else
+                num = this->transport_stored->writev(iov, num_iov);
+            
+            if(num < 0)
+            {
+                this->stats_recorder.sent(0, false);
+                
+                if(errno == EINTR)
+                    continue;
+                if(errno == EAGAIN && blocking == false)                                    // the port is full, the caller waits without the queue
+                    return false;
+                
+                SerialStatus status = SerialStatus::TIMEOUT;
+                
+                if(errno == EAGAIN)                                                         // kernel buffer is full, wait until the port is writable
+                {
+                    status = this->wait_port(POLLOUT, message->deadline);
+                    
+                    if(status == SerialStatus::OK)
+                        continue;
+                }
+                else if(errno != ETIME)
+                {
+                    status = SerialStatus::IO_ERROR;
+                }
+                
+                this->tx_buffer.clear();                                                    // the data is partly sent, do not send it twice
+                
+                if(status == SerialStatus::TIMEOUT)                                         // the next messages have their own deadline
+                    this->complete_tx(std::make_exception_ptr(SerialTimeoutException("Serial write: Timeout occured")), waiting, count);
+                else
+                    this->complete_tx(std::make_exception_ptr(SerialError("Serial write: Unable to write data on serialport.")), waiting, count);
+                continue;
+            }
+            
+            if(num > 0 && this->capture_stored.active() == true)
+                this->capture_stored.record(CaptureDirection::TX, this->capture_channel, iov, num_iov, num);
+            
+            this->stats_recorder.sent(num, (size_t)num < total);                            // partial write if buffers are left
+            
+            if((size_t)num == total)
+            {
+                this->stats_recorder.write_completed(elapsed_ns(start));
+                start = std::chrono::steady_clock::now();
+            }
+            
+            this->consume_tx(num, waiting, count);
+        }
+        
+        return true;
+    }
+    
+    
+    void Serial::consume_tx(size_t num, std::atomic<uint32_t>** waiting, int& count)
+    {
+        size_t queued_num = (num < this->tx_buffer.size()) ? num : this->tx_buffer.size();
+        
+        if(queued_num == this->tx_buffer.size())                                            // keeps the capacity for the next queued writes
+            this->tx_buffer.clear();
+        else
+            this->tx_buffer.erase(this->tx_buffer.begin(), this->tx_buffer.begin() + queued_num);
+        
+        num -= queued_num;
+        
+        while(this->tx_pending != NULL && this->tx_pending->queued == false)
+        {
+            TxMessage* message = this->tx_pending;
+            size_t size = 0;
+            
+            for(int i = 0; i < message->count; i++)
+                size += message->iov[i].iov_len;
+            
+            if(num < size - message->sent)                                                  // continued by the next call, before any other message
+            {
+                message->sent += num;
+                return;
+            }
+            
+            num -= size - message->sent;
+            this->complete_tx(NULL, waiting, count);
+        }
+    }
+    
+    
+    void Serial::complete_tx(std::exception_ptr error, std::atomic<uint32_t>** waiting, int& count)
+    {
+        TxMessage* message = this->tx_pending;
+        this->tx_pending = message->next;                                                   // the message is destroyed by its thread once it is done
+        
+        if(this->tx_pending == NULL)
+            this->tx_pending_last = NULL;
+        
+        message->error = error;
+        
+        if(message->notify_fd >= 0)                                                         // async write, its task is resumed by the eventfd
+        {
+            TxAsyncMessage* async = static_cast<TxAsyncMessage*>(message);
+            
+            if(async == this->tx_driver)
+                this->tx_driver = NULL;
+            
+            async->state.store(SERIAL_TX_DONE, std::memory_order_release);
+            eventfd_write(async->notify_fd, 1);
+            async->release();                                                               // reference of the queue
+        }
+        else if(message->state.exchange(SERIAL_TX_DONE, std::memory_order_release) == SERIAL_TX_WAITING)
+        {
+            if(count == SERIAL_TX_WAKE_SIZE)                                                // waking a stale address is harmless, the futex word is only compared
+                syscall(SYS_futex, &message->state, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+            else
+                waiting[count++] = &message->state;
+        }
+    }
+    
+    
+    void Serial::fail_pending(std::exception_ptr error, std::atomic<uint32_t>** waiting, int& count)
+    {
+        this->tx_buffer.clear();
+        
+        while(this->tx_pending != NULL)
+            this->complete_tx(error, waiting, count);
+    }
+    
+    
+    bool Serial::release_tx(TxAsyncMessage* own, std::atomic<uint32_t>** waiting, int count)
+    {
+        TxMessage* blocking = this->tx_pending;
+        
+        while(blocking != NULL && blocking->notify_fd >= 0)
+            blocking = blocking->next;
+        
+        for(int i = 0; i < count; i++)
+            syscall(SYS_futex, waiting[i], FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+        
+        if(blocking != NULL)                                                                // a thread waits in a blocking write, it keeps the queue and sends all messages
+        {
+            if(blocking->state.exchange(SERIAL_TX_HANDOFF, std::memory_order_acq_rel) == SERIAL_TX_WAITING)
+                syscall(SYS_futex, &blocking->state, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+            
+            return false;
+        }
+        
+        this->pick_driver(own);
+        this->tx_active.store(false, std::memory_order_seq_cst);
+        return true;
+    }
+    
+    
+    void Serial::pick_driver(TxAsyncMessage* own)
+    {
+        if(this->tx_driver != NULL && (this->tx_driver->driving.load() == false || this->tx_driver->abandoned.load() == true))
+            this->tx_driver = NULL;                                                         // its task stopped waiting for the port
+        
+        if(this->tx_driver != NULL || this->tx_pending == NULL)
+            return;
+        
+        if(own != NULL && own->state.load(std::memory_order_acquire) != SERIAL_TX_DONE)     // the running task waits for the port without a wake
+        {
+            own->driving.store(true);
+            this->tx_driver = own;
+            return;
+        }
+        
+        for(TxMessage* message = this->tx_pending; message != NULL; message = message->next)
+        {
+            TxAsyncMessage* async = static_cast<TxAsyncMessage*>(message);                  // only async writes are left, blocking ones keep the queue
+            
+            if(async->abandoned.load() == false)
+            {
+                async->driving.store(true);
+                this->tx_driver = async;
+                eventfd_write(async->notify_fd, 1);                                         // its task sends the queue, then waits for the port
+                return;
+            }
+        }
+    }
+    
+    
+    void Serial::poll_tx(TxAsyncMessage* own)
+    {
+        do
+        {
+            std::atomic<uint32_t>* waiting[SERIAL_TX_WAKE_SIZE];
+            int count = 0;
+            
+            this->tx_reschedule.store(false, std::memory_order_seq_cst);
+            
+            try
+            {
+                this->collect_tx();
+                this->send_pending(false, waiting, count);
+            }
+            catch(...)
+            {
+                this->fail_pending(std::current_exception(), waiting, count);               // no message is left in a queue which nobody sends
+            }
+            
+            if(this->release_tx(own, waiting, count) == false)
+                return;
+        }
+        while((this->tx_queue.empty() == false || this->tx_reschedule.load(std::memory_order_seq_cst) == true) && this->tx_active.exchange(true, std::memory_order_seq_cst) == false);
+    }
+    
+    
+    Serial::TxAsyncMessage* Serial::start_async_tx(std::span<const uint8_t> data, Deadline deadline)
+    {
+        if(this->tx_active.exchange(true, std::memory_order_seq_cst) == true)               // another writer holds the queue, the copy is sent after its messages
+        {
+            TxAsyncMessage* copy = this->copy_tx(data, deadline, 0);
+            this->tx_queue.push(copy);
+            
+            if(this->tx_active.exchange(true, std::memory_order_seq_cst) == false)          // the writer released the queue before the push
+                this->poll_tx(copy);
+            
+            return copy;
+        }
+        
+        struct iovec iov;
+        iov.iov_base = (void*)data.data();
+        iov.iov_len = data.size();
+        
+        TxMessage message;                                                                  // on the stack while tx_active is held, copied if the port is full
+        message.iov = &iov;
+        message.count = 1;
+        message.queued = false;
+        message.deadline = deadline;
+        message.sent = 0;
+        message.error = NULL;
+        message.notify_fd = -1;
+        message.state.store(SERIAL_TX_PENDING, std::memory_order_relaxed);
+        message.next = NULL;
+        
+        std::atomic<uint32_t>* waiting[SERIAL_TX_WAKE_SIZE];
+        int count = 0;
+        TxAsyncMessage* copy = NULL;
+        
+        this->tx_reschedule.store(false, std::memory_order_seq_cst);
+        
+        try
+        {
+            this->collect_tx();
+            
+            if(this->tx_pending == NULL)
+                this->tx_pending = &message;
+            else
+                this->tx_pending_last->next = &message;
+            
+            this->tx_pending_last = &message;
+            
+            if(this->send_pending(false, waiting, count) == false)                          // the message is the last one, so it is still pending
+            {
+                copy = this->copy_tx(data, deadline, message.sent);
+                TxMessage** link = &this->tx_pending;
+                
+                while(*link != &message)
+                    link = &(*link)->next;
+                
+                *link = copy;
+                this->tx_pending_last = copy;
+            }
+        }
+        catch(...)
+        {
+            this->fail_pending(std::current_exception(), waiting, count);
+        }
+        
+        if(this->release_tx(copy, waiting, count) == true && (this->tx_queue.empty() == false || this->tx_reschedule.load(std::memory_order_seq_cst) == true) && this->tx_active.exchange(true, std::memory_order_seq_cst) == false)
+            this->poll_tx(copy);
+        
+        if(copy == NULL && message.error)
+            std::rethrow_exception(message.error);
+        
+        return copy;
+    }
+    
+    
+    Serial::TxAsyncMessage* Serial::copy_tx(std::span<const uint8_t> data, Deadline deadline, size_t sent)
+    {
+        std::unique_ptr<TxAsyncMessage> copy = std::make_unique<TxAsyncMessage>();
+        copy->data.assign(data.begin(), data.end());                                        // the task may be destroyed before the message is sent
+        copy->notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        
+        if(copy->notify_fd < 0)
+            throw SerialError("Serial async write: Unable to create completion event.");
+        
+        copy->buffer.iov_base = copy->data.data();
+        copy->buffer.iov_len = copy->data.size();
+        copy->iov = &copy->buffer;
+        copy->count = 1;
+        copy->queued = false;
+        copy->deadline = deadline;
+        copy->sent = sent;
+        copy->error = NULL;
+        copy->state.store(SERIAL_TX_PENDING, std::memory_order_relaxed);
+        copy->next = NULL;
+        copy->references.store(2, std::memory_order_relaxed);                               // the task and the queue
+        copy->driving.store(false);
+        copy->abandoned.store(false);
+        
+        return copy.release();
+    }
+    
+    
+    void Serial::resume_async_tx(TxAsyncMessage* message)
+    {
+        if(this->tx_active.exchange(true, std::memory_order_seq_cst) == false)
+        {
+            this->poll_tx(message);
+            return;
+        }
+        
+        message->driving.store(false);                                                      // the holder of the queue picks the task which waits for the port
+        this->tx_reschedule.store(true, std::memory_order_seq_cst);
+        
+        if(this->tx_active.exchange(true, std::memory_order_seq_cst) == false)              // released before the flag was set
+            this->poll_tx(message);
+    }
+    
+    
+    void Serial::abandon_async_tx(TxAsyncMessage* message)
+    {
+        message->abandoned.store(true);
+        message->driving.store(false);
+        this->tx_reschedule.store(true, std::memory_order_seq_cst);                         // the holder of the queue drops the message or picks another task
+        
+        if(this->tx_active.exchange(true, std::memory_order_seq_cst) == false)
+            this->poll_tx(NULL);
+    }
+    
+    
+    void Serial::TxAsyncMessage::release(void)
+    {
+        if(this->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            ::close(this->notify_fd);
+            delete this;
+        }
+    }
+    
+    
+    std::string Serial::readline(void)
+    {
+        return this->readline(seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    std::string Serial::readline(std::chrono::nanoseconds timeout)
+    {
+        std::string line;
+        throw_status(this->try_readline(line, timeout), "Serial readline");
+        
+        return line;
+    }
+    
+    
+    std::vector<uint8_t> Serial::read_until(std::string expected)
+    {
+        return this->read_until(expected, 0, seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    std::vector<uint8_t> Serial::read_until(std::string expected, size_t max_size)
+    {
+        return this->read_until(expected, max_size, seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    std::vector<uint8_t> Serial::read_until(std::string expected, size_t max_size, std::chrono::nanoseconds timeout)
+    {
+        if(expected.empty() == true)
+            throw SerialError("Serial read until: Expected sequence must not be empty.");
+        
+        std::vector<uint8_t> data;
+        throw_status(this->try_read_until(data, expected, max_size, timeout), "Serial read until");
+        
+        return data;
+    }
+    
+    
+    std::vector<uint8_t> Serial::read(uint32_t size)
+    {
+        return this->read(size, seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    std::vector<uint8_t> Serial::read(uint32_t size, std::chrono::nanoseconds timeout)
+    {
+        std::vector<uint8_t> data;
+        throw_status(this->try_read(data, size, timeout), "Serial read");
+        
+        return data;
+    }
+    
+    
+    size_t Serial::readline_into(std::span<char> buffer)
+    {
+        return this->readline_into(buffer, seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    size_t Serial::readline_into(char* buffer, size_t size)
+    {
+        return this->readline_into(std::span<char>(buffer, size), seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    size_t Serial::readline_into(std::span<char> buffer, std::chrono::nanoseconds timeout)
+    {
+        size_t num;
+        throw_status(this->try_readline_into(buffer, num, timeout), "Serial readline");
+        
+        return num;
+    }
+    
+    
+    size_t Serial::read_into(std::span<uint8_t> buffer)
+    {
+        return this->read_into(buffer, seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    size_t Serial::read_into(uint8_t* buffer, size_t size)
+    {
+        return this->read_into(std::span<uint8_t>(buffer, size), seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    size_t Serial::read_into(std::span<uint8_t> buffer, std::chrono::nanoseconds timeout)
+    {
+        size_t num;
+        throw_status(this->try_read_into(buffer, num, timeout), "Serial read");
+        
+        return num;
+    }
+    
+    
+    SerialStatus Serial::try_readline(std::string& line)
+    {
+        return this->try_readline(line, seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    SerialStatus Serial::try_readline(std::string& line, std::chrono::nanoseconds timeout)
+    {
+        if(this->open_flag == false)
+            return SerialStatus::CLOSED;
+        if(this->reader_callback_flag == true)
+            return SerialStatus::CALLBACK;
+        
+        size_t num;
+        SerialStatus status = this->wait_until(this->terminator_stored, SIZE_MAX, deadline_from(timeout), num);
+        
+        if(status != SerialStatus::OK)
+            return status;                                                                  // received data stays buffered
+        
+        line.assign((const char*)this->rx_buffer.data(), num);                              // keeps the capacity of the caller's string
+        this->rx_buffer.consume(num);
+        
+        return SerialStatus::OK;
+    }
+    
+    
+    std::vector<std::string_view> Serial::readlines(void)
+    {
+        return this->readlines(seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    std::vector<std::string_view> Serial::readlines(std::chrono::nanoseconds timeout)
+    {
+        std::vector<std::string_view> lines;
+        throw_status(this->try_readlines(lines, timeout), "Serial readlines");
+        
+        return lines;
+    }
+    
+    
+    SerialStatus Serial::try_readlines(std::vector<std::string_view>& lines)
+    {
+        return this->try_readlines(lines, seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    SerialStatus Serial::try_readlines(std::vector<std::string_view>& lines, std::chrono::nanoseconds timeout)
+    {
+        lines.clear();                                                                      // keeps the capacity of the caller's vector
+        
+        if(this->open_flag == false)
+            return SerialStatus::CLOSED;
+        if(this->reader_callback_flag == true)
+            return SerialStatus::CALLBACK;
+        
+        size_t num;
+        SerialStatus status = this->drain(num);                                             // everything queued with one read in most cases
+        
+        if(status == SerialStatus::OK)                                                      // waits only if no complete line is buffered
+            status = this->wait_until(this->terminator_stored, SIZE_MAX, deadline_from(timeout), num);
+        
+        if(status != SerialStatus::OK)
+            return status;                                                                  // received data stays buffered
+        
+        const std::string& term = this->terminator_stored;
+        const uint8_t* pattern = (const uint8_t*)term.data();
+        const uint8_t* data = this->rx_buffer.data();
+        size_t size = this->rx_buffer.size();
+        lines.push_back(std::string_view((const char*)data, num));
+        
+        while(true)                                                                         // all further complete lines, a partial line stays buffered
+        {
+            const uint8_t* pos = find_sequence(data + num, size - num, pattern, term.size());
+            
+            if(pos == NULL)
+                break;
+            
+            size_t line_end = (pos - data) + term.size();
+            lines.push_back(std::string_view((const char*)data + num, line_end - num));
+            num = line_end;
+        }
+        
+        this->rx_buffer.consume(num);                                                       // the storage is not overwritten until the next read
+        
+        return SerialStatus::OK;
+    }
+    
+    
+    SerialStatus Serial::try_read_until(std::vector<uint8_t>& data, const std::string& expected, size_t max_size)
+    {
+        return this->try_read_until(data, expected, max_size, seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    SerialStatus Serial::try_read_until(std::vector<uint8_t>& data, const std::string& expected, size_t max_size, std::chrono::nanoseconds timeout)
+    {
+        if(this->open_flag == false)
+            return SerialStatus::CLOSED;
+        if(expected.empty() == true)
+            return SerialStatus::INVALID_ARGUMENT;
+        if(this->reader_callback_flag == true)
+            return SerialStatus::CALLBACK;
+        
+        size_t num;
+        SerialStatus status = this->wait_until(expected, (max_size == 0) ? SIZE_MAX : max_size, deadline_from(timeout), num);
+        
+        if(status != SerialStatus::OK)
+            return status;
+        
+        data.assign(this->rx_buffer.data(), this->rx_buffer.data() + num);
+        this->rx_buffer.consume(num);
+        
+        return SerialStatus::OK;
+    }
+    
+    
+    SerialStatus Serial::try_read(std::vector<uint8_t>& data, uint32_t size)
+    {
+        return this->try_read(data, size, seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    SerialStatus Serial::try_read(std::vector<uint8_t>& data, uint32_t size, std::chrono::nanoseconds timeout)
+    {
+        size_t num = 0;
+        data.resize(size);
+        
+        SerialStatus status = this->try_read_into(data, num, timeout);
+        data.resize(num);                                                                   // shorter after an inter-byte timeout, empty on errors
+        
+        return status;
+    }
+    
+    
+    SerialStatus Serial::try_readline_into(std::span<char> buffer, size_t& num)
+    {
+        return this->try_readline_into(buffer, num, seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    SerialStatus Serial::try_readline_into(std::span<char> buffer, size_t& num, std::chrono::nanoseconds timeout)
+    {
+        num = 0;
+        
+        if(this->open_flag == false)
+            return SerialStatus::CLOSED;
+        if(buffer.empty() == true)
+            return SerialStatus::OK;
+        if(this->reader_callback_flag == true)
+            return SerialStatus::CALLBACK;
+        
+        size_t size;
+        SerialStatus status = this->wait_until(this->terminator_stored, buffer.size(), deadline_from(timeout), size);  // a longer line is returned in pieces
+        
+        if(status != SerialStatus::OK)
+            return status;                                                                  // received data stays buffered
+        
+        num = this->rx_buffer.read((uint8_t*)buffer.data(), size);
+        return SerialStatus::OK;
+    }
+    
+    
+    SerialStatus Serial::try_read_into(std::span<uint8_t> buffer, size_t& num)
+    {
+        return this->try_read_into(buffer, num, seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    SerialStatus Serial::try_read_into(std::span<uint8_t> buffer, size_t& num, std::chrono::nanoseconds timeout)
+    {
+        num = 0;
+        
+        if(this->open_flag == false)
+            return SerialStatus::CLOSED;
+        if(this->reader_callback_flag == true)
+            return SerialStatus::CALLBACK;
+        
+        Deadline deadline = deadline_from(timeout);
+        Deadline last_received = std::chrono::steady_clock::now();
+        size_t size = buffer.size();
+        size_t received = this->rx_buffer.read(buffer.data(), size);                        // already buffered data first
+        
+        while(received < size)
+        {
+            Deadline wait_deadline = this->gap_deadline(deadline, last_received, received > 0);
+            SerialStatus status;
+            ssize_t num_temp = 0;
+            
+            if(this->reader_ring != NULL)                                                   // the reader thread has drained the port already
+                status = this->wait_ring(wait_deadline);
+            else if(this->busy_poll_stored > 0.0 && (num_temp = this->spin_read(buffer.data() + received, size - received, wait_deadline)) != 0)
+                status = SerialStatus::OK;                                                  // data or an error while spinning, no wait necessary
+            else if(this->uring != NULL)                                                    // wait and read with one system call
+            {
+                struct iovec iov = {buffer.data() + received, size - received};
+                num_temp = this->uring_transfer(POLLIN, &iov, 1, wait_deadline);
+                status = (num_temp >= 0) ? SerialStatus::OK : ((errno == ETIME) ? SerialStatus::TIMEOUT : SerialStatus::IO_ERROR);
+            }
+            else
+                status = this->wait_port(POLLIN, wait_deadline);
+            
+            if(status == SerialStatus::TIMEOUT && wait_deadline < deadline)
+                break;                                                                      // inter-byte timeout occured, return the received data
+            
+            if(status != SerialStatus::OK)
+            {
+                std::span<uint8_t> free_space = this->rx_buffer.prepare(received);          // keep the received data for the next call
+                std::memcpy(free_space.data(), buffer.data(), received);
+                this->rx_buffer.commit(received);
+                
+                return status;
+            }
+            
+            if(this->reader_ring != NULL)
+                received += this->reader_ring->read(buffer.data() + received, size - received);
+            else
+            {
+                if(this->uring == NULL && num_temp == 0)
+                    num_temp = this->read_port(buffer.data() + received, size - received);  // read directly into the caller's buffer
+                
+                if(num_temp <= 0)
+                {
+                    std::span<uint8_t> free_space = this->rx_buffer.prepare(received);
+                    std::memcpy(free_space.data(), buffer.data(), received);
+                    this->rx_buffer.commit(received);
+                    
+                    return SerialStatus::IO_ERROR;
+                }
+                
+                received += num_temp;
+            }
+            
+            if(this->inter_byte_timeout_stored >= 0.0)
+                last_received = std::chrono::steady_clock::now();
+        }
+        
+        num = received;
+        return SerialStatus::OK;
+    }
+    
+    
+    PooledBuffer Serial::read_pooled(uint32_t size)
+    {
+        return this->read_pooled(size, seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    PooledBuffer Serial::read_pooled(uint32_t size, std::chrono::nanoseconds timeout)
+    {
+        PooledBuffer buffer;
+        throw_status(this->try_read_pooled(buffer, size, timeout), "Serial read");
+        
+        return buffer;
+    }
+    
+    
+    PooledBuffer Serial::readline_pooled(void)
+    {
+        return this->readline_pooled(seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    PooledBuffer Serial::readline_pooled(std::chrono::nanoseconds timeout)
+    {
+        PooledBuffer buffer;
+        throw_status(this->try_readline_pooled(buffer, timeout), "Serial readline");
+        
+        return buffer;
+    }
+    
+    
+    SerialStatus Serial::try_read_pooled(PooledBuffer& buffer, uint32_t size, std::chrono::nanoseconds timeout)
+    {
+        size_t num = 0;
+        buffer = this->buffer_pool_stored.acquire(size);                                    // releases the previous buffer of the caller
+        
+        SerialStatus status = this->try_read_into(std::span<uint8_t>(buffer.data(), size), num, timeout);
+        
+        if(status != SerialStatus::OK)
+            buffer.reset();                                                                 // received data stays buffered
+        else
+            buffer.resize(num);
+        
+        return status;
+    }
+    
+    
+    SerialStatus Serial::try_readline_pooled(PooledBuffer& buffer, std::chrono::nanoseconds timeout)
+    {
+        buffer.reset();
+        
+        if(this->open_flag == false)
+            return SerialStatus::CLOSED;
+        if(this->reader_callback_flag == true)
+            return SerialStatus::CALLBACK;
+        
+        size_t num;
+        SerialStatus status = this->wait_until(this->terminator_stored, SIZE_MAX, deadline_from(timeout), num);
+        
+        if(status != SerialStatus::OK)
+            return status;
+        
+        buffer = this->buffer_pool_stored.acquire(num);
+        buffer.resize(this->rx_buffer.read(buffer.data(), num));
+        
+        return SerialStatus::OK;
+    }
+    
+    
+    size_t Serial::read_some(std::span<uint8_t> buffer)
+    {
+        return this->read_some(buffer, seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    size_t Serial::read_some(std::span<uint8_t> buffer, std::chrono::nanoseconds timeout)
+    {
+        size_t num;
+        throw_status(this->try_read_some(buffer, num, timeout), "Serial read some");
+        
+        return num;
+    }
+    
+    
+    SerialStatus Serial::try_read_some(std::span<uint8_t> buffer, size_t& num)
+    {
+        return this->try_read_some(buffer, num, seconds_to_duration(this->timeout_stored));
+    }
+    
+    
+    SerialStatus Serial::try_read_some(std::span<uint8_t> buffer, size_t& num, std::chrono::nanoseconds timeout)
+    {
+        num = 0;
+        
+        if(this->open_flag == false)
+            return SerialStatus::CLOSED;
+        if(this->reader_callback_flag == true)
+            return SerialStatus::CALLBACK;
+        if(buffer.empty() == true)
+            return SerialStatus::OK;
+        
+        if(this->rx_buffer.empty() == false)                                                // buffered data, no syscall necessary
+        {
+            num = this->rx_buffer.read(buffer.data(), buffer.size());
+            return SerialStatus::OK;
+        }
+        
+        Deadline deadline = deadline_from(timeout);
+        
+        if(this->reader_ring != NULL)
+        {
+            SerialStatus status = this->wait_ring(deadline);
+            
+            if(status == SerialStatus::OK)
+                num = this->reader_ring->read(buffer.data(), buffer.size());
+            
+            return status;
+        }
+        
+        if(this->busy_poll_stored > 0.0)
+        {
+            ssize_t num_temp = this->spin_read(buffer.data(), buffer.size(), deadline);
+            
+            if(num_temp < 0)
+                return SerialStatus::IO_ERROR;
+            
+            if(num_temp > 0)
+            {
+                num = num_temp;
+                return SerialStatus::OK;
+            }
+        }
+        
+        if(this->uring != NULL)                                                             // waiting and reading take one system call anyway
+        {
+            struct iovec iov = {buffer.data(), buffer.size()};
+            ssize_t num_temp = this->uring_transfer(POLLIN, &iov, 1, deadline);
+            
+            if(num_temp < 0 && errno == ETIME)
+                return SerialStatus::TIMEOUT;
+            if(num_temp <= 0)
+                return SerialStatus::IO_ERROR;
+            
+            num = num_temp;
+            return SerialStatus::OK;
+        }
+        
+        while(true)
+        {
+            ssize_t num_temp = this->read_port(buffer.data(), buffer.size());               // try first, the data is often there already
+            
+            if(num_temp > 0)
+            {
+                num = num_temp;
+                return SerialStatus::OK;
+            }
+            else if(num_temp < 0 && errno == EINTR)
+                continue;
+            else if(num_temp < 0 && errno != EAGAIN)                                        // VMIN = 0, an empty read means no data
+                return SerialStatus::IO_ERROR;
+            
+            SerialStatus status = this->wait_port(POLLIN, deadline);
+            
+            if(status != SerialStatus::OK)
+                return status;
+        }
+    }
+    
+    
+    Deadline Serial::gap_deadline(Deadline deadline, Deadline last_received, bool received)
+    {
+        if(this->inter_byte_timeout_stored < 0.0 || received == false)
+            return deadline;                                                                // no inter-byte timeout before the first byte
+        
+        Deadline gap_end = last_received + seconds_to_duration(this->inter_byte_timeout_stored);
+        
+        return (gap_end < deadline) ? gap_end : deadline;
+    }
+    
+    
+    ssize_t Serial::read_port(uint8_t* buffer, size_t size)
+    {
+        ssize_t num = this->transport_stored->read(buffer, size);
+        this->stats_recorder.received((num > 0) ? num : 0);
+        
+        if(num > 0 && this->capture_stored.active() == true)
+            this->capture_stored.record(CaptureDirection::RX, this->capture_channel, std::span<const uint8_t>(buffer, num));
+        
+        return num;
+    }
+    
+    
+    ssize_t Serial::spin_read(uint8_t* buffer, size_t size, Deadline deadline)
+    {
+        auto start = std::chrono::steady_clock::now();
+        Deadline spin_end = start + seconds_to_duration(this->busy_poll_stored);
+        
+        if(deadline < spin_end)
+            spin_end = deadline;
+        
+        while(true)
+        {
+            ssize_t num = this->read_port(buffer, size);                                    // VMIN = 0, returns immediately without data
+            
+            if(num > 0)
+            {
+                this->stats_recorder.spin(elapsed_ns(start), true);
+                return num;
+            }
+            
+            if(num < 0 && errno != EAGAIN && errno != EINTR)
+                return -1;
+            
+            if(std::chrono::steady_clock::now() >= spin_end)
+            {
+                this->stats_recorder.spin(elapsed_ns(start), false);
+                return 0;                                                                   // budget used up, the caller blocks
+            }
+        }
+    }
+    
+    
+    SerialStatus Serial::wait_port(short events, Deadline deadline)
+    {
+        auto start = std::chrono::steady_clock::now();
+        
+        while(true)
+        {
+            struct timespec timeout_struct;
+            int status = this->transport_stored->wait(events, remaining_time(deadline, &timeout_struct));
+            
+            if(events & POLLIN)
+                this->stats_recorder.rx_syscall();
+            else
+                this->stats_recorder.tx_syscall();
+            
+            if(status == -1)
+            {
+                if(errno == EINTR)
+                    continue;                                                               // the deadline stays the same
+                return SerialStatus::IO_ERROR;                                              // error occured
+            }
+            
+            if(events & POLLIN)
+                this->stats_recorder.rx_wait(elapsed_ns(start), status == 0);
+            else if(status == 0)
+                this->stats_recorder.tx_timeout();
+            
+            return (status > 0) ? SerialStatus::OK : SerialStatus::TIMEOUT;
+        }
+    }
+    
+    
+    ssize_t Serial::uring_transfer(short events, struct iovec* iov, int count, Deadline deadline)
+    {
+        IoUring* ring = (events & POLLIN) ? this->uring.get() : this->tx_uring.get();       // reading and writing threads have their own ring
+        
+        struct io_uring_sqe* poll_sqe = ring->sqe();
+        struct io_uring_sqe* transfer_sqe = ring->sqe();
+        
+        if(poll_sqe == NULL || transfer_sqe == NULL)                                        // entries of a failed call, the linked pair must not be split
+        {
+            ring->discard();
+            throw SerialError("Serial: io_uring submission queue is full.");
+        }
+        
+        poll_sqe->opcode = IORING_OP_POLL_ADD;
+        poll_sqe->fd = 0;                                                                   // index of the registered file
+        poll_sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_LINK;                                 // the transfer starts when the poll has completed
+        poll_sqe->poll32_events = events;
+        poll_sqe->user_data = SERIAL_URING_POLL;
+        
+        transfer_sqe->opcode = (events & POLLIN) ? IORING_OP_READV : IORING_OP_WRITEV;
+        transfer_sqe->fd = 0;
+        transfer_sqe->flags = IOSQE_FIXED_FILE;
+        transfer_sqe->addr = (uint64_t)iov;
+        transfer_sqe->len = count;
+        transfer_sqe->user_data = SERIAL_URING_TRANSFER;
+        
+        auto start = std::chrono::steady_clock::now();
+        unsigned pending = 2;
+        int calls = 0;
+        int poll_result = 0;
+        int transfer_result = 0;
+        bool cancelled = false;
+        
+        while(pending > 0)
+        {
+            struct timespec timeout_struct;
+            int status = ring->submit(pending, (cancelled == true) ? NULL : remaining_time(deadline, &timeout_struct));
+            calls++;
+            
+            struct io_uring_cqe cqe;
+            
+            while(ring->completion(cqe) == true)
+            {
+                pending--;
+                
+                if(cqe.user_data == SERIAL_URING_POLL)
+                    poll_result = cqe.res;
+                else if(cqe.user_data == SERIAL_URING_TRANSFER)
+                    transfer_result = cqe.res;
+            }
+            
+            if(status < 0 && status != -ETIME && status != -EINTR && status != -EAGAIN && status != -EBUSY)   // EAGAIN and EBUSY are retried after reaping
+            {
+                this->cancel_uring(ring, pending - ring->discard());                       // the kernel must not write into the buffers after the throw
+                throw SerialError("Serial: io_uring wait failed.");
+            }
+            
+            if(pending > 0 && cancelled == false && deadline != Deadline::max() && std::chrono::steady_clock::now() >= deadline)
+            {
+                struct io_uring_sqe* cancel_sqe = ring->sqe();                              // the linked transfer is cancelled with the poll
+                
+                if(cancel_sqe == NULL)                                                      // tried again after the next completions
+                    continue;
+                
+                cancel_sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                cancel_sqe->addr = SERIAL_URING_POLL;
+                cancel_sqe->user_data = SERIAL_URING_CANCEL;
+                pending++;
+                cancelled = true;
+            }
+        }
+        
+        bool timeout = (transfer_result == -ECANCELED && (poll_result == -ECANCELED || poll_result >= 0));
+        
+        if(events & POLLIN)                                                                 // the first call is counted with the transferred bytes
+        {
+            this->stats_recorder.received((transfer_result > 0) ? transfer_result : 0);
+            this->stats_recorder.rx_wait(elapsed_ns(start), timeout);
+            
+            if(transfer_result > 0 && this->capture_stored.active() == true)                // the transmit path records in send
+                this->capture_stored.record(CaptureDirection::RX, this->capture_channel, iov, count, transfer_result);
+            
+            for(int i = 1; i < calls; i++)
+                this->stats_recorder.rx_syscall();
+        }
+        else
+        {
+            if(timeout == true)
+                this->stats_recorder.tx_timeout();
+            
+            for(int i = 1; i < calls; i++)
+                this->stats_recorder.tx_syscall();
+        }
+        
+        if(timeout == true)
+        {
+            errno = ETIME;
+            return -1;
+        }
+        
+        if(poll_result < 0)
+            transfer_result = poll_result;
+        
+        if(transfer_result < 0)
+        {
+            errno = -transfer_result;
+            return -1;
+        }
+        
+        return transfer_result;
+    }
+    
+    
+    void Serial::cancel_uring(IoUring* ring, unsigned pending)
+    {
+        if(pending == 0)
+            return;
+        
+        struct io_uring_sqe* cancel_sqe = ring->sqe();                                      // also if a cancel is pending, a second one completes at once
+        
+        if(cancel_sqe != NULL)
+        {
+            cancel_sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            cancel_sqe->addr = SERIAL_URING_POLL;
+            cancel_sqe->user_data = SERIAL_URING_CANCEL;
+            pending++;
+        }
+        
+        while(pending > 0)
+        {
+            struct io_uring_cqe cqe;
+            
+            if(ring->submit(pending, NULL) < 0)                                             // the kernel posts the completions without the call as well
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            
+            while(ring->completion(cqe) == true)
+                pending--;
+        }
+    }
+    
+    
+    SerialStatus Serial::wait_ring(Deadline deadline)
+    {
+        struct timespec timeout_struct;
+        auto start = std::chrono::steady_clock::now();
+        
+        if(this->busy_poll_stored > 0.0 && this->reader_ring->size() == 0)                  // spin on the ring instead of sleeping on the futex
+        {
+            Deadline spin_end = start + seconds_to_duration(this->busy_poll_stored);
+            
+            if(deadline < spin_end)
+                spin_end = deadline;
+            
+            while(this->reader_ring->size() == 0 && std::chrono::steady_clock::now() < spin_end);
+            
+            bool hit = (this->reader_ring->size() > 0);
+            this->stats_recorder.spin(elapsed_ns(start), hit);
+            
+            if(hit == true)
+                return SerialStatus::OK;
+        }
+        
+        bool ready = this->reader_ring->wait_readable(remaining_time(deadline, &timeout_struct));
+        
+        this->stats_recorder.rx_wait(elapsed_ns(start), ready == false);
+        
+        if(ready == true)
+            return SerialStatus::OK;
+        
+        if(this->reader_error == true)
+            return SerialStatus::IO_ERROR;                                                  // reader thread stopped, unable to read data on serialport
+        
+        return SerialStatus::TIMEOUT;
+    }
+    
+    
+    SerialStatus Serial::fill(Deadline deadline)
+    {
+        if(this->reader_ring != NULL)                                                       // take the data from the reader thread without a syscall
+        {
+            SerialStatus status = this->wait_ring(deadline);
+            
+            if(status != SerialStatus::OK)
+                return status;
+            
+            std::span<uint8_t> free_space = this->rx_buffer.prepare(SERIAL_RX_CHUNK_SIZE);
+            this->rx_buffer.commit(this->reader_ring->read(free_space.data(), free_space.size()));
+            return SerialStatus::OK;
+        }
+        
+        std::span<uint8_t> free_space = this->rx_buffer.prepare(SERIAL_RX_CHUNK_SIZE);
+        ssize_t num = 0;
+        
+        if(this->busy_poll_stored > 0.0)                                                    // data or an error while spinning needs no wait
+            num = this->spin_read(free_space.data(), free_space.size(), deadline);
+        
+        if(num == 0 && this->uring != NULL)                                                 // wait and read with one system call
+        {
+            struct iovec iov = {free_space.data(), free_space.size()};
+            num = this->uring_transfer(POLLIN, &iov, 1, deadline);
+            
+            if(num < 0 && errno == ETIME)
+                return SerialStatus::TIMEOUT;
+        }
+        else if(num == 0)
+        {
+            SerialStatus status = this->wait_port(POLLIN, deadline);
+            
+            if(status != SerialStatus::OK)
+                return status;
+            
+            num = this->read_port(free_space.data(), free_space.size());                    // read everything available in one call
+        }
+        
+        if(num <= 0)
+            return SerialStatus::IO_ERROR;
+        
+        this->rx_buffer.commit(num);
+        return SerialStatus::OK;
+    }
+    
+    
+    SerialStatus Serial::wait_until(const std::string& expected, size_t max_size, Deadline deadline, size_t& num)
+    {
+        const uint8_t* pattern = (const uint8_t*)expected.data();
+        size_t searched = 0;                                                                // bytes already known to contain no match start
+        Deadline last_received = std::chrono::steady_clock::now();
+        
+        while(true)
+        {
+            size_t available = (this->rx_buffer.size() < max_size) ? this->rx_buffer.size() : max_size;
+            
+            if(available >= expected.size())
+            {
+                const uint8_t* data = this->rx_buffer.data();
+                const uint8_t* pos = find_sequence(data + searched, available - searched, pattern, expected.size());
+                
+                if(pos != NULL)
+                {
+                    num = (pos - data) + expected.size();
+                    return SerialStatus::OK;
+                }
+                
+                searched = available - expected.size() + 1;
+            }
+            
+            if(this->rx_buffer.size() >= max_size)
+            {
+                num = max_size;                                                             // no match within max_size bytes
+                return SerialStatus::OK;
+            }
+            
+            Deadline wait_deadline = this->gap_deadline(deadline, last_received, this->rx_buffer.empty() == false);
+            SerialStatus status = this->fill(wait_deadline);
+            
+            if(status == SerialStatus::TIMEOUT && wait_deadline < deadline)
+            {
+                num = available;                                                            // inter-byte timeout occured, return the received data
+                return SerialStatus::OK;
+            }
+            
+            if(status != SerialStatus::OK)
+            {
+                num = 0;
+                return status;
+            }
+            
+            if(this->inter_byte_timeout_stored >= 0.0)
+                last_received = std::chrono::steady_clock::now();
+        }
+    }
+    
+    
+    size_t Serial::receive(void)
+    {
+        if(this->open_flag == true)
+        {
+            if(this->reader_callback_flag == true)
+                throw SerialError("Serial receive: Received data is delivered by callback.");
+            
+            size_t num = 0;
+            
+            if(this->drain(num) != SerialStatus::OK)
+                throw SerialError("Serial receive: Unable to read data on serialport.");
+            
+            return num;
+        }
+        else
+        {
+            throw SerialError("Serial receive: Serial is closed.");
+        }
+    }
+    
+    
+    SerialStatus Serial::drain(size_t& num)
+    {
+        num = 0;
+        
+        if(this->reader_ring != NULL)                                                       // the reader thread has drained the port already
+        {
+            while(this->reader_ring->size() > 0)
+            {
+                std::span<uint8_t> free_space = this->rx_buffer.prepare(this->reader_ring->size());
+                size_t num_temp = this->reader_ring->read(free_space.data(), free_space.size());
+                this->rx_buffer.commit(num_temp);
+                num += num_temp;
+            }
+            
+            return SerialStatus::OK;
+        }
+        
+        while(true)
+        {
+            std::span<uint8_t> free_space = this->rx_buffer.prepare(SERIAL_RX_CHUNK_SIZE);
+            ssize_t num_temp = this->read_port(free_space.data(), free_space.size());
+            
+            if(num_temp > 0)
+            {
+                this->rx_buffer.commit(num_temp);
+                num += num_temp;
+                
+                if((size_t)num_temp < free_space.size())                                    // kernel buffer is empty, avoid a further read call
+                    return SerialStatus::OK;
+            }
+            else if(num_temp == 0 || errno == EAGAIN)                                       // VMIN is 0, no data is not an error
+                return SerialStatus::OK;
+            else if(errno != EINTR)
+                return SerialStatus::IO_ERROR;
+        }
+    }
+    
+    
+    size_t Serial::in_waiting(void)
+    {
+        if(this->reader_callback_flag == true)                                              // rx_buffer belongs to the dispatch thread, the ring is safe to read
+            return this->reader_ring->size();
+        
+        return this->rx_buffer.size() + ((this->reader_ring != NULL) ? this->reader_ring->size() : 0);
+    }    
+    
+    Task<std::vector<uint8_t>> Serial::async_read(EventLoop& loop, uint32_t size)
+    {
+        return this->read_async(loop, size, deadline_from(seconds_to_duration(this->timeout_stored)), NULL);
+    }
+    
+    
+    Task<std::vector<uint8_t>> Serial::async_read(EventLoop& loop, uint32_t size, std::chrono::nanoseconds timeout)
+    {
+        return this->read_async(loop, size, deadline_from(timeout), NULL);
+    }
+    
+    
+    Task<std::vector<uint8_t>> Serial::async_read(EventLoop& loop, uint32_t size, std::chrono::nanoseconds timeout, Cancellation& cancellation)
+    {
+        return this->read_async(loop, size, deadline_from(timeout), &cancellation);
+    }
+    
+    
+    Task<std::string> Serial::async_readline(EventLoop& loop)
+    {
+        return this->readline_async(loop, deadline_from(seconds_to_duration(this->timeout_stored)), NULL);
+    }
+    
+    
+    Task<std::string> Serial::async_readline(EventLoop& loop, std::chrono::nanoseconds timeout)
+    {
+        return this->readline_async(loop, deadline_from(timeout), NULL);
+    }
+    
+    
+    Task<std::string> Serial::async_readline(EventLoop& loop, std::chrono::nanoseconds timeout, Cancellation& cancellation)
+    {
+        return this->readline_async(loop, deadline_from(timeout), &cancellation);
+    }
+    
+    
+    Task<size_t> Serial::async_write(EventLoop& loop, std::string_view data)
+    {
+        return this->write_async(loop, std::span<const uint8_t>((const uint8_t*)data.data(), data.size()), deadline_from(seconds_to_duration(this->write_timeout_stored)), NULL);
+    }
+    
+    
+    Task<size_t> Serial::async_write(EventLoop& loop, std::span<const uint8_t> data)
+    {
+        return this->write_async(loop, data, deadline_from(seconds_to_duration(this->write_timeout_stored)), NULL);
+    }
+    
+    
+    Task<size_t> Serial::async_write(EventLoop& loop, std::span<const uint8_t> data, std::chrono::nanoseconds timeout, Cancellation& cancellation)
+    {
+        return this->write_async(loop, data, deadline_from(timeout), &cancellation);
+    }
+    
+    
+    Task<SerialStatus> Serial::async_try_read_some(EventLoop& loop, std::span<uint8_t> buffer, size_t& num, std::chrono::nanoseconds timeout)
+    {
+        return this->read_some_async(loop, buffer, num, deadline_from(timeout));
+    }
+    
+    
+    void Serial::attach(EventLoop& loop, bool receiving, const char* function)
+    {
+        if(this->open_flag == false)
+            throw SerialError(std::string(function) + ": Serial is closed.");
+        if(receiving == true && this->reader_ring != NULL)
+            throw SerialError(std::string(function) + ": Received data is delivered by the reader thread.");
+        
+        if(this->event_loop != NULL && *this->event_loop == &loop)
+            return;
+        
+        if(this->event_loop != NULL && *this->event_loop != NULL)                           // the port is registered in one loop at a time
+            (*this->event_loop)->remove(this->serial_fd);
+        
+        this->event_loop = loop.reference();
+    }
+    
+    
+    Task<std::vector<uint8_t>> Serial::read_async(EventLoop& loop, uint32_t size, Deadline deadline, Cancellation* cancellation)
+    {
+        this->attach(loop, true, "Serial async read");
+        
+        while(this->rx_buffer.size() < size)
+        {
+            if(this->receive() > 0)
+                continue;
+            
+            auto start = std::chrono::steady_clock::now();                                  // kernel buffer is empty, wait for the next edge
+            WaitResult result = co_await loop.readable(this->serial_fd, deadline, cancellation);
+            
+            this->stats_recorder.rx_wait(elapsed_ns(start), result == WaitResult::TIMEOUT);
+            check_wait(result, "Serial async read");                                        // received data stays buffered
+        }
+        
+        std::vector<uint8_t> data(this->rx_buffer.data(), this->rx_buffer.data() + size);
+        this->rx_buffer.consume(size);
+        
+        co_return data;
+    }
+    
+    
+    Task<std::string> Serial::readline_async(EventLoop& loop, Deadline deadline, Cancellation* cancellation)
+    {
+        this->attach(loop, true, "Serial async readline");
+        
+        std::string expected = this->terminator_stored;
+        const uint8_t* pattern = (const uint8_t*)expected.data();
+        size_t searched = 0;                                                                // bytes already known to contain no match start
+        
+        while(true)
+        {
+            size_t available = this->rx_buffer.size();
+            
+            if(available >= expected.size())
+            {
+                const uint8_t* data = this->rx_buffer.data();
+                const uint8_t* pos = find_sequence(data + searched, available - searched, pattern, expected.size());
+                
+                if(pos != NULL)
+                {
+                    size_t num = (pos - data) + expected.size();
+                    std::string line((const char*)data, num);
+                    this->rx_buffer.consume(num);
+                    
+                    co_return line;
+                }
+                
+                searched = available - expected.size() + 1;
+            }
+            
+            if(this->receive() > 0)
+                continue;
+            
+            auto start = std::chrono::steady_clock::now();
+            WaitResult result = co_await loop.readable(this->serial_fd, deadline, cancellation);
+            
+            this->stats_recorder.rx_wait(elapsed_ns(start), result == WaitResult::TIMEOUT);
+            check_wait(result, "Serial async readline");
+        }
+    }
+    
+    
+    Task<size_t> Serial::write_async(EventLoop& loop, std::span<const uint8_t> data, Deadline deadline, Cancellation* cancellation)
+    {
+        this->attach(loop, false, "Serial async write");
+        
+        TxAsyncMessage* message = this->start_async_tx(data, deadline);                    // tx_active is only held while the port takes data
+        
+        if(message == NULL)
+            co_return data.size();
+        
+        struct Guard                                                                        // also runs if the task is destroyed while it waits
+        {
+            Serial* serial;
+            EventLoop* loop;
+            TxAsyncMessage* message;
+            
+            ~Guard()
+            {
+                if(this->message->state.load(std::memory_order_acquire) != SERIAL_TX_DONE)
+                    this->serial->abandon_async_tx(this->message);
+                
+                this->loop->remove(this->message->notify_fd);
+                this->message->release();
+            }
+        } guard = {this, &loop, message};
+        
+        while(message->state.load(std::memory_order_acquire) != SERIAL_TX_DONE)
+        {
+            WaitResult result;
+            
+            if(message->driving.load() == true)                                             // the port was full, this task sends the queue once it is writable
+            {
+                if(this->transport_stored->output_events() == false)                        // the wait would return at once and spin
+                    throw SerialError("Serial async write: Transport can not wait until writable.");
+                
+                result = co_await loop.writable(this->serial_fd, deadline, cancellation);
+                
+                if(result == WaitResult::READY)
+                {
+                    this->resume_async_tx(message);
+                    continue;
+                }
+            }
+            else
+            {
+                eventfd_t value;
+                
+                if(eventfd_read(message->notify_fd, &value) == 0)                           // done, or picked to wait for the port
+                {
+                    if(message->driving.load() == true)
+                        this->resume_async_tx(message);
+                    continue;
+                }
+                
+                result = co_await loop.readable(message->notify_fd, deadline, cancellation);
+                
+                if(result == WaitResult::READY)
+                    continue;
+            }
+            
+            if(result == WaitResult::TIMEOUT)
+                this->stats_recorder.tx_timeout();
+            check_wait(result, "Serial async write");                                       // the guard abandons the message
+        }
+        
+        if(message->error)
+            std::rethrow_exception(message->error);
+        
+        co_return data.size();
+    }
+    
+    
+    Task<SerialStatus> Serial::read_some_async(EventLoop& loop, std::span<uint8_t> buffer, size_t& num, Deadline deadline)
+    {
+        num = 0;
+        
+        if(this->open_flag == false)
+            co_return SerialStatus::CLOSED;
+        if(this->reader_callback_flag == true)
+            co_return SerialStatus::CALLBACK;
+        
+        this->attach(loop, true, "Serial async try read some");
+        
+        while(buffer.empty() == false)
+        {
+            if(this->rx_buffer.empty() == false)
+            {
+                num = this->rx_buffer.read(buffer.data(), buffer.size());
+                break;
+            }
+            
+            ssize_t num_temp = this->read_port(buffer.data(), buffer.size());
+            
+            if(num_temp > 0)
+            {
+                num = num_temp;
+                break;
+            }
+            else if(num_temp < 0 && errno == EINTR)
+                continue;
+            else if(num_temp < 0 && errno != EAGAIN)
+                co_return SerialStatus::IO_ERROR;
+            
+            auto start = std::chrono::steady_clock::now();                                  // kernel buffer is empty, wait for the next edge
+            WaitResult result = co_await loop.readable(this->serial_fd, deadline, NULL);
+            
+            this->stats_recorder.rx_wait(elapsed_ns(start), result == WaitResult::TIMEOUT);
+            
+            if(result == WaitResult::TIMEOUT)
+                co_return SerialStatus::TIMEOUT;
+        }
+        
+        co_return SerialStatus::OK;
+    }
+    
+    
+    void Serial::start_reader(void)
+    {
+        this->launch_reader();
+    }
+    
+    
+    void Serial::start_reader(ChunkCallback chunk_callback)
+    {
+        this->launch_reader();
+        this->reader_callback_flag = true;
+        this->dispatch_thread = std::thread(&Serial::dispatch_chunks, this, chunk_callback);
+    }
+    
+    
+    void Serial::start_line_reader(LineCallback line_callback)
+    {
+        this->launch_reader();
+        this->reader_callback_flag = true;
+        this->dispatch_thread = std::thread(&Serial::dispatch_lines, this, line_callback);
+    }
+    
+    
+    void Serial::stop_reader(void)
+    {
+        if(this->reader_ring == NULL)
+            throw SerialError("Serial stop reader: Reader is not running.");
+        
+        uint64_t wake_value = 1;
+        if(::write(this->reader_wake_fd, &wake_value, sizeof(wake_value)) < 0)
+            throw SerialError("Serial stop reader: Unable to stop reader.");
+        
+        this->reader_ring->close();
+        this->reader_thread.join();
+        
+        if(this->dispatch_thread.joinable() == true)
+            this->dispatch_thread.join();
+        
+        ::close(this->reader_wake_fd);
+        this->reader_wake_fd = -1;
+        
+        while(this->reader_ring->size() > 0)                                                // keep data which was not consumed yet
+        {
+            std::span<uint8_t> free_space = this->rx_buffer.prepare(this->reader_ring->size());
+            this->rx_buffer.commit(this->reader_ring->read(free_space.data(), free_space.size()));
+        }
+        
+        this->reader_ring.reset();
+        this->reader_callback_flag = false;
+    }
+    
+    
+    bool Serial::reader_running(void)
+    {
+        return this->reader_ring != NULL;
+    }
+    
+    
+    void Serial::launch_reader(void)
+    {
+        if(this->open_flag == false)
+            throw SerialError("Serial start reader: Serial is closed.");
+        if(this->reader_ring != NULL)
+            throw SerialError("Serial start reader: Reader is already running.");
+        
+        this->reader_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        
+        if(this->reader_wake_fd < 0)
+            throw SerialError("Serial start reader: Unable to create wake-up event.");
+        
+        this->reader_error = false;
+        this->reader_ring = std::make_unique<SpscRing>(SERIAL_READER_RING_SIZE);
+        this->reader_thread = std::thread(&Serial::reader_loop, this);
+    }
+    
+    
+    void Serial::reader_loop(void)
     {
-        std::string empty_string;
+        tune_thread(this->busy_poll_cpu_stored, this->busy_poll_priority_stored);           // succeeded for the thread which set it
         
-        if(this->open_flag == true)
+        struct pollfd fds[2];
+        fds[0].fd = this->serial_fd;
+        fds[0].events = POLLIN;
+        fds[1].fd = this->reader_wake_fd;
+        fds[1].events = POLLIN;
+        
+        while(true)
         {
-            struct termios port_settings;
-            if(tcgetattr(this->serial_fd, &port_settings) != 0)                             // read existing settings
-                throw SerialError("Serial readline: Failed to read existing port settings.");
-            port_settings.c_lflag |= ICANON;                                                // process input when a newline character is received
-            if(tcsetattr(this->serial_fd, TCSANOW, &port_settings) != 0)                    // save serial settings
-                throw SerialError("Serial readline: Failed to set port settings.");
+            if(this->reader_ring->is_closed() == true)                                      // a busy polling reader with continuous data never reaches poll
+                return;                                                                     // reader is stopped
             
+            std::span<uint8_t> free_space = this->reader_ring->write_span();
             
-            fd_set set;
-            FD_ZERO(&set);                                                                  // clear the file descriptor set
-            FD_SET(this->serial_fd, &set);                                                  // add the serial file descriptor to the set
+            if(free_space.empty() == true)                                                  // consumer is behind, the kernel buffers meanwhile
+            {
+                if(this->reader_ring->wait_writable(NULL) == false)
+                    return;                                                                 // reader is stopped
+                continue;
+            }
             
+            if(this->busy_poll_stored > 0.0)
+            {
+                ssize_t num = this->spin_read(free_space.data(), free_space.size(), Deadline::max());
+                
+                if(num > 0)
+                {
+                    this->reader_ring->produce(num);
+                    continue;
+                }
+                else if(num < 0)
+                    break;
+            }
             
-            struct timeval* timeout_ptr;
-            struct timeval timeout_struct;
+            this->stats_recorder.rx_syscall();
             
-            if(this->timeout_stored < 0.0)
-                timeout_ptr = NULL;
-            else
+            if(poll(fds, 2, -1) < 0)
             {
-                timeout_struct.tv_sec = (int)this->timeout_stored;
-                timeout_struct.tv_usec = ((int)(this->timeout_stored * 1000000.0) % 1000000);
-                timeout_ptr = &timeout_struct;
+                if(errno == EINTR)
+                    continue;
+                break;
             }
             
+            if(fds[1].revents != 0)
+                return;                                                                     // reader is stopped
             
-            int status = select(this->serial_fd + 1, &set, NULL, NULL, timeout_ptr);
+            int num = this->read_port(free_space.data(), free_space.size());
             
-            if(status == -1)
-                throw SerialError("Serial readline: Select failed.");                       // error occured
-            else if(status == 0)
-                throw SerialTimeoutException("Serial readline: Timeout occured");           // timeout occured
+            if(num > 0)
+                this->reader_ring->produce(num);
+            else if(num < 0 && (errno == EAGAIN || errno == EINTR))
+                continue;
             else
-            {
-                char data_buffer[SERIAL_RX_LINE_BUFFER_SIZE + 1];                           // size for received data and plus one for '\0'
-                int num = ::read(this->serial_fd, data_buffer, SERIAL_RX_LINE_BUFFER_SIZE);
-                
-                if(num <= 0)
-                    throw SerialError("Serial readline: Unable to read data on serialport.");
-                else
-                {
-                    if(num < SERIAL_RX_LINE_BUFFER_SIZE + 1)
-                    {
-                        data_buffer[num] = '\0';
-                        std::string data(data_buffer);
-                        return data;
-                    }
-                    else
-                        throw SerialError("Serial readline: Index out of bounds.");
-                }
-            }
+                break;
         }
-        else
+        
+        this->reader_error = true;                                                          // port failed, wake up the consumer
+        this->reader_ring->close();
+    }
+    
+    
+    void Serial::dispatch_chunks(ChunkCallback callback)
+    {
+        if(this->rx_buffer.empty() == false)                                                // data received before the reader was started
         {
-            throw SerialError("Serial readline: Serial is closed.");
+            callback(std::span<const uint8_t>(this->rx_buffer.data(), this->rx_buffer.size()));
+            this->rx_buffer.clear();
         }
         
-        return empty_string;
+        while(this->reader_ring->wait_readable(NULL) == true)
+        {
+            std::span<const uint8_t> data = this->reader_ring->read_span();
+            callback(data);
+            this->reader_ring->consume(data.size());
+        }
     }
     
     
-    std::vector<uint8_t> Serial::read(uint32_t size)
+    void Serial::dispatch_lines(LineCallback callback)
     {
-        std::vector<uint8_t> empty_vector;
+        const std::string term = this->terminator_stored;
+        const uint8_t* pattern = (const uint8_t*)term.data();
         
-        if(this->open_flag == true)
+        while(true)
         {
-            struct termios port_settings;
-            if(tcgetattr(this->serial_fd, &port_settings) != 0)                             // read existing settings
-                throw SerialError("Serial read: Failed to read existing port settings.");
-            port_settings.c_lflag &= ~ICANON;                                               // raw mode
-            if(tcsetattr(this->serial_fd, TCSANOW, &port_settings) != 0)                    // save serial settings
-                throw SerialError("Serial read: Failed to set port settings.");
+            const uint8_t* data = this->rx_buffer.data();
+            size_t size = this->rx_buffer.size();
+            size_t num = 0;
             
-            
-            fd_set set;
-            FD_ZERO(&set);                                                                  // clear the file descriptor set
-            FD_SET(this->serial_fd, &set);                                                  // add the serial file descriptor to the set
-            
-            
-            struct timeval* timeout_ptr;
-            struct timeval timeout_struct;
-            
-            if(this->timeout_stored < 0.0)
-                timeout_ptr = NULL;
-            else
+            while(true)                                                                     // deliver all complete lines
             {
-                timeout_struct.tv_sec = (int)this->timeout_stored;
-                timeout_struct.tv_usec = ((int)(this->timeout_stored * 1000000.0) % 1000000);
-                timeout_ptr = &timeout_struct;
+                const uint8_t* pos = find_sequence(data + num, size - num, pattern, term.size());
+                
+                if(pos == NULL)
+                    break;
+                
+                size_t line_end = (pos - data) + term.size();
+                callback(std::string_view((const char*)data + num, line_end - num));
+                num = line_end;
             }
             
+            this->rx_buffer.consume(num);
             
-            std::vector<uint8_t> data(size);
-            uint32_t num = 0;
-            
-            while(num < size)
-            {
-                int status = select(this->serial_fd + 1, &set, NULL, NULL, timeout_ptr);
-                
-                if(status == -1)
-                    throw SerialError("Serial read: Select failed.");                       // error occured
-                else if(status == 0)
-                    throw SerialTimeoutException("Serial read: Timeout occured");           // timeout occured
-                else
-                {
-                    std::vector<uint8_t> data_buffer_temp(size - num);
-                    int num_temp = ::read(this->serial_fd, &data_buffer_temp[0], data_buffer_temp.size());
-                    
-                    if(num_temp <= 0)
-                        throw SerialError("Serial read: Unable to read data on serialport.");
-                    else
-                    {
-                        for(int i = 0; i < num_temp; i++)
-                        {
-                            if(i + num < size)
-                                data[i + num] = data_buffer_temp[i];
-                            else
-                                break;
-                        }
-                        
-                        num += num_temp;
-                    }
-                }
-            }
+            if(this->reader_ring->wait_readable(NULL) == false)
+                return;
             
-            return data;
+            std::span<uint8_t> free_space = this->rx_buffer.prepare(SERIAL_RX_CHUNK_SIZE);
+            this->rx_buffer.commit(this->reader_ring->read(free_space.data(), free_space.size()));
         }
-        else
-        {
-            throw SerialError("Serial read: Serial is closed.");
-        }
-        
-        return empty_vector;
     }
     
     
@@ -336,8 +2401,16 @@ namespace serial
     {
         if(this->open_flag == true)
         {
-            if(tcflush(this->serial_fd, TCIFLUSH) != 0)
+            if(this->transport_stored->flush(true, false) == false)
                 throw SerialError("Serial reset input buffer: Unable to reset buffer.");
+            
+            if(this->reader_callback_flag == false)                                         // the buffers belong to the dispatch thread otherwise
+            {
+                this->rx_buffer.clear();
+                
+                if(this->reader_ring != NULL)
+                    this->reader_ring->consume(this->reader_ring->size());
+            }
         }
         else
         {
@@ -350,7 +2423,7 @@ namespace serial
     {
         if(this->open_flag == true)
         {
-            if(tcflush(this->serial_fd, TCOFLUSH) != 0)
+            if(this->transport_stored->flush(false, true) == false)
                 throw SerialError("Serial reset output buffer: Unable to reset buffer.");
         }
         else
@@ -364,18 +2437,8 @@ namespace serial
     {
         if(this->open_flag == true)
         {
-            int bit_mask = TIOCM_RTS;
-            
-            if(state == true)
-            {
-                if(ioctl(this->serial_fd, TIOCMBIS, &bit_mask) != 0)
-                    throw SerialError("Serial RTS: Unable to write RTS.");
-            }
-            else
-            {
-                if(ioctl(this->serial_fd, TIOCMBIC, &bit_mask) != 0)
-                    throw SerialError("Serial RTS: Unable to write RTS.");
-            }
+            if(this->transport_stored->set_lines(TIOCM_RTS, state) == false)
+                throw SerialError("Serial RTS: Unable to write RTS.");
         }
         else
         {
@@ -388,18 +2451,8 @@ namespace serial
     {
         if(this->open_flag == true)
         {
-            int bit_mask = TIOCM_DTR;
-            
-            if(state == true)
-            {
-                if(ioctl(this->serial_fd, TIOCMBIS, &bit_mask) != 0)
-                    throw SerialError("Serial DTR: Unable to write DTR.");
-            }
-            else
-            {
-                if(ioctl(this->serial_fd, TIOCMBIC, &bit_mask) != 0)
-                    throw SerialError("Serial DTR: Unable to write DTR.");
-            }
+            if(this->transport_stored->set_lines(TIOCM_DTR, state) == false)
+                throw SerialError("Serial DTR: Unable to write DTR.");
         }
         else
         {
@@ -414,7 +2467,7 @@ namespace serial
         {
             int bit_mask;
             
-            if(ioctl(this->serial_fd, TIOCMGET, &bit_mask) != 0)
+            if(this->transport_stored->get_lines(bit_mask) == false)
                 throw SerialError("Serial RTS: Unable to read RTS.");
             
             if(bit_mask & TIOCM_RTS)
@@ -435,7 +2488,7 @@ namespace serial
         {
             int bit_mask;
             
-            if(ioctl(this->serial_fd, TIOCMGET, &bit_mask) != 0)
+            if(this->transport_stored->get_lines(bit_mask) == false)
                 throw SerialError("Serial DTR: Unable to read DTR.");
             
             if(bit_mask & TIOCM_DTR)
@@ -456,7 +2509,7 @@ namespace serial
         {
             int bit_mask;
             
-            if(ioctl(this->serial_fd, TIOCMGET, &bit_mask) != 0)
+            if(this->transport_stored->get_lines(bit_mask) == false)
                 throw SerialError("Serial CTS: Unable to read CTS.");
             
             if(bit_mask & TIOCM_CTS)
@@ -477,10 +2530,10 @@ namespace serial
         {
             int bit_mask;
             
-            if(ioctl(this->serial_fd, TIOCMGET, &bit_mask) != 0)
+            if(this->transport_stored->get_lines(bit_mask) == false)
                 throw SerialError("Serial DSR: Unable to read DSR.");
             
-            if(bit_mask & TIOCM_LE)
+            if(bit_mask & TIOCM_DSR)
                 return true;
             else
                 return false;
@@ -492,12 +2545,122 @@ namespace serial
     }
     
     
+    static std::string latency_timer_path(const std::string& port)
+    {
+        std::error_code error;
+        std::filesystem::path device = std::filesystem::canonical(port, error);             // resolve links like /dev/serial/by-id/...
+        
+        if(error)
+            return std::string();
+        
+        return "/sys/class/tty/" + device.filename().string() + "/device/latency_timer";
+    }
+    
+    
+    LowLatencyStatus Serial::low_latency(bool state)
+    {
+        if(this->open_flag == true)
+        {
+            int serial_error = 0;
+            
+            if(dynamic_cast<TtyTransport*>(this->transport_stored.get()) != NULL)           // sockets and memory pairs have no driver settings
+            {
+                if(state == true && this->low_latency_saved == false)                       // keep the settings from before the first enable
+                {
+                    LowLatencyStatus previous = this->low_latency();
+                    this->async_low_latency_saved = previous.async_low_latency;
+                    this->latency_timer_saved = previous.latency_timer;
+                    this->low_latency_saved = true;
+                }
+                
+                bool flag = (state == true) || (this->low_latency_saved == true && this->async_low_latency_saved == true);
+                int latency_timer = (state == true) ? SERIAL_LATENCY_TIMER_LOW : ((this->low_latency_saved == true) ? this->latency_timer_saved : -1);
+                struct serial_struct serial_info;
+                
+                if(ioctl(this->serial_fd, TIOCGSERIAL, &serial_info) == 0)                  // not supported by every driver, e.g. ptys
+                {
+                    if(flag == true)
+                        serial_info.flags |= ASYNC_LOW_LATENCY;
+                    else
+                        serial_info.flags &= ~ASYNC_LOW_LATENCY;
+                    
+                    if(ioctl(this->serial_fd, TIOCSSERIAL, &serial_info) != 0)
+                        serial_error = errno;
+                }
+                
+                if(latency_timer >= 0)                                                      // unknown without a saved value, left as it is
+                {
+                    std::ofstream latency_timer_file(latency_timer_path(this->port_stored));
+                    
+                    if(latency_timer_file.is_open() == true)                                // only exists for USB adapters like FTDI
+                        latency_timer_file << latency_timer << std::endl;
+                }
+                
+                if(state == false)
+                    this->low_latency_saved = false;
+            }
+            
+            LowLatencyStatus status = this->low_latency();                                  // read back what the driver applied
+            status.serial_error = serial_error;
+            
+            return status;
+        }
+        else
+        {
+            throw SerialError("Serial low latency: Serial is closed.");
+        }
+    }
+    
+    
+    LowLatencyStatus Serial::low_latency(void)
+    {
+        if(this->open_flag == true)
+        {
+            LowLatencyStatus status;
+            struct serial_struct serial_info;
+            
+            status.async_low_latency = false;
+            status.latency_timer = -1;
+            status.serial_error = 0;
+            
+            if(dynamic_cast<TtyTransport*>(this->transport_stored.get()) == NULL)
+                return status;
+            
+            if(ioctl(this->serial_fd, TIOCGSERIAL, &serial_info) == 0)
+                status.async_low_latency = (serial_info.flags & ASYNC_LOW_LATENCY) != 0;
+            
+            std::ifstream latency_timer_file(latency_timer_path(this->port_stored));
+            
+            if(latency_timer_file.is_open() == true)
+            {
+                if(!(latency_timer_file >> status.latency_timer))
+                    status.latency_timer = -1;
+            }
+            
+            return status;
+        }
+        else
+        {
+            throw SerialError("Serial low latency: Serial is closed.");
+        }
+    }
+    
+    
     bool Serial::is_open(void)
     {
         return this->open_flag;
     }
     
     
+    int Serial::fileno(void)
+    {
+        if(this->open_flag == false)
+            throw SerialError("Serial fileno: Serial is closed.");
+        
+        return this->serial_fd;
+    }
+    
+    
     std::string Serial::port(void)
     {
         return this->port_stored;
@@ -507,6 +2670,7 @@ namespace serial
     void Serial::port(std::string new_port)
     {
         this->port_stored = new_port;
+        this->low_latency_saved = false;                                                    // the saved settings belong to the previous device
     }
     
     
@@ -518,6 +2682,12 @@ namespace serial
     
     void Serial::baudrate(uint32_t new_baudrate)
     {
+        if(this->open_flag == true)                                                         // change the baudrate of the open port directly
+        {
+            if(this->transport_stored->baudrate(new_baudrate) == false)
+                throw SerialError("Serial baudrate: Baudrate is not supported.");
+        }
+        
         this->baudrate_stored = new_baudrate;
     }
     
@@ -534,6 +2704,202 @@ namespace serial
     }
     
     
+    float Serial::inter_byte_timeout(void)
+    {
+        return this->inter_byte_timeout_stored;
+    }
+    
+    
+    void Serial::inter_byte_timeout(float new_timeout)
+    {
+        this->inter_byte_timeout_stored = new_timeout;
+    }
+    
+    
+    float Serial::write_timeout(void)
+    {
+        return this->write_timeout_stored;
+    }
+    
+    
+    void Serial::write_timeout(float new_timeout)
+    {
+        this->write_timeout_stored = new_timeout;
+    }
+    
+    
+    size_t Serial::tx_threshold(void)
+    {
+        return this->tx_threshold_stored;
+    }
+    
+    
+    void Serial::tx_threshold(size_t new_threshold)
+    {
+        this->tx_threshold_stored = new_threshold;
+    }
+    
+    
+    Backend Serial::backend(void)
+    {
+        if(this->open_flag == true)
+            return (this->uring != NULL) ? Backend::IO_URING : Backend::POSIX;              // the backend in use after a fallback
+        
+        return this->backend_stored;
+    }
+    
+    
+    void Serial::backend(Backend new_backend)
+    {
+        this->backend_stored = new_backend;
+    }
+    
+    
+    std::shared_ptr<Transport> Serial::transport(void)
+    {
+        return this->transport_stored;
+    }
+    
+    
+    void Serial::transport(std::shared_ptr<Transport> new_transport)
+    {
+        if(this->open_flag == true)
+            throw SerialError("Serial transport: Serial is open.");
+        if(new_transport == NULL)
+            throw SerialError("Serial transport: Transport must not be empty.");
+        
+        this->transport_stored = new_transport;
+    }
+    
+    
+    SettlePolicy Serial::settle_policy(void)
+    {
+        return this->settle_policy_stored;
+    }
+    
+    
+    void Serial::settle_policy(SettlePolicy new_policy)
+    {
+        this->settle_policy_stored = new_policy;
+    }
+    
+    
+    float Serial::settle_time(void)
+    {
+        return this->settle_time_stored;
+    }
+    
+    
+    void Serial::settle_time(float new_time)
+    {
+        this->settle_time_stored = new_time;
+    }
+    
+    
+    float Serial::busy_poll(void)
+    {
+        return this->busy_poll_stored;
+    }
+    
+    
+    void Serial::busy_poll(float new_budget)
+    {
+        if(new_budget < 0.0)
+            throw SerialError("Serial busy poll: Budget must not be negative.");
+        
+        this->busy_poll_stored = new_budget;
+    }
+    
+    
+    void Serial::busy_poll(float new_budget, int cpu, int priority)
+    {
+        if(new_budget < 0.0)
+            throw SerialError("Serial busy poll: Budget must not be negative.");
+        if(cpu >= CPU_SETSIZE || priority < 0 || priority > sched_get_priority_max(SCHED_FIFO))
+            throw SerialError("Serial busy poll: Invalid CPU or priority.");
+        if(tune_thread(cpu, priority) == false)
+            throw SerialError("Serial busy poll: Unable to pin or prioritize the calling thread.");
+        
+        this->busy_poll_stored = new_budget;
+        this->busy_poll_cpu_stored = cpu;
+        this->busy_poll_priority_stored = priority;
+    }
+    
+    
+    int Serial::busy_poll_cpu(void)
+    {
+        return this->busy_poll_cpu_stored;
+    }
+    
+    
+    int Serial::busy_poll_priority(void)
+    {
+        return this->busy_poll_priority_stored;
+    }
+    
+    
+    BufferPool Serial::buffer_pool(void)
+    {
+        return this->buffer_pool_stored;
+    }
+    
+    
+    void Serial::buffer_pool(BufferPool pool)
+    {
+        this->buffer_pool_stored = pool;
+    }
+    
+    
+    Capture Serial::capture(void)
+    {
+        return this->capture_stored;
+    }
+    
+    
+    void Serial::capture(Capture new_capture)
+    {
+        this->capture(new_capture, 0);
+    }
+    
+    
+    void Serial::capture(Capture new_capture, uint16_t channel)
+    {
+        this->capture_stored = new_capture;
+        this->capture_channel = channel;
+    }
+    
+    
+    std::string Serial::terminator(void)
+    {
+        return this->terminator_stored;
+    }
+    
+    
+    void Serial::terminator(std::string new_terminator)
+    {
+        if(new_terminator.empty() == true)
+            throw SerialError("Serial terminator: Terminator must not be empty.");
+        
+        this->terminator_stored = new_terminator;
+    }
+    
+    
+    SerialStats Serial::stats(void)
+    {
+        SerialStats stats;
+        this->stats_recorder.snapshot(stats);
+        read_icount(this->open_flag ? this->serial_fd : -1, stats);
+        
+        return stats;
+    }
+    
+    
+    void Serial::reset_stats(void)
+    {
+        this->stats_recorder.reset();
+    }
+    
+    
     std::ostream& operator<< (std::ostream &out, Serial const& serial_obj)
     {
         out << "Port name: " << serial_obj.port_stored << std::endl;
@@ -547,7 +2913,13 @@ namespace serial
         if(serial_obj.open_flag == false)
             out << "Status: Closed";
         else
-            out << "Status: Open";
+        {
+            SerialStats stats;
+            serial_obj.stats_recorder.snapshot(stats);
+            read_icount(serial_obj.serial_fd, stats);
+            
+            out << "Status: Open" << std::endl << stats;
+        }
         
         return out;
     }
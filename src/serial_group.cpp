@@ -0,0 +1,329 @@
+/**
+ * @file serial_group.cpp
+ * @brief Serial group source file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ */
+
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "serial_group.hpp"
+
+
+#define SERIAL_GROUP_MAX_EVENTS                 64                                  // events handled per epoll_wait call
+#define SERIAL_GROUP_WORKER_EVENTS              4                                   // fewer per worker, so idle workers get events too
+
+
+namespace serial
+{
+    SerialGroup::SerialGroup()
+    {
+        this->stop_flag = false;
+        this->oneshot_flag = false;
+        
+        this->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        
+        if(this->epoll_fd < 0)
+            throw SerialError("Serial group: Unable to create epoll instance.");
+        
+        this->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        
+        if(this->wake_fd < 0)
+        {
+            ::close(this->epoll_fd);
+            throw SerialError("Serial group: Unable to create wake-up event.");
+        }
+        
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = NULL;                                                              // marks the wake-up event
+        
+        if(epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, this->wake_fd, &event) != 0)
+        {
+            ::close(this->wake_fd);
+            ::close(this->epoll_fd);
+            throw SerialError("Serial group: Unable to register wake-up event.");
+        }
+    }
+    
+    
+    SerialGroup::~SerialGroup()
+    {
+        try
+        {
+            if(this->workers.empty() == false)
+                this->stop();
+        }
+        catch(...)
+        {
+        }
+        
+        ::close(this->wake_fd);
+        ::close(this->epoll_fd);
+    }
+    
+    
+    void SerialGroup::add(Serial& serial, SerialHandler readable_handler)
+    {
+        this->add(serial, readable_handler, SerialHandler());
+    }
+    
+    
+    void SerialGroup::add(Serial& serial, SerialHandler readable_handler, SerialHandler writable_handler)
+    {
+        if(this->workers.empty() == false)
+            throw SerialError("Serial group add: Worker threads are running.");
+        if(serial.is_open() == false)
+            throw SerialError("Serial group add: Serial is closed.");
+        if(serial.reader_running() == true)
+            throw SerialError("Serial group add: Serial has its own reader thread.");
+        if(this->find(serial) != NULL)
+            throw SerialError("Serial group add: Serial is already in the group.");
+        
+        std::unique_ptr<Member> member = std::make_unique<Member>();
+        member->serial = &serial;
+        member->fd = serial.fileno();
+        member->readable_handler = readable_handler;
+        member->writable_handler = writable_handler;
+        member->writable_flag = false;
+        member->removed_flag = false;
+        
+        this->update(member.get(), EPOLL_CTL_ADD);
+        this->members.push_back(std::move(member));
+    }
+    
+    
+    void SerialGroup::remove(Serial& serial)
+    {
+        if(this->workers.empty() == false)
+            throw SerialError("Serial group remove: Worker threads are running.");
+        
+        for(size_t i = 0; i < this->members.size(); i++)
+        {
+            if(this->members[i]->serial == &serial && this->members[i]->removed_flag == false)
+            {
+                epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, this->members[i]->fd, NULL);
+                this->members[i]->removed_flag = true;                                      // events of the current dispatch may still refer to it
+                this->removed_members.push_back(std::move(this->members[i]));
+                this->members.erase(this->members.begin() + i);
+                return;
+            }
+        }
+        
+        throw SerialError("Serial group remove: Serial is not in the group.");
+    }
+    
+    
+    void SerialGroup::writable(Serial& serial, bool state)
+    {
+        Member* member = this->find(serial);
+        
+        if(member == NULL)
+            throw SerialError("Serial group writable: Serial is not in the group.");
+        if(state == true && serial.transport()->output_events() == false)
+            throw SerialError("Serial group writable: Transport can not wait until writable.");
+        
+        if(member->writable_flag != state)
+        {
+            member->writable_flag = state;
+            this->update(member, EPOLL_CTL_MOD);
+        }
+    }
+    
+    
+    void SerialGroup::error_handler(SerialErrorHandler handler)
+    {
+        this->error_handler_stored = handler;
+    }
+    
+    
+    size_t SerialGroup::size(void)
+    {
+        return this->members.size();
+    }
+    
+    
+    size_t SerialGroup::poll(float timeout)
+    {
+        if(this->workers.empty() == false)
+            throw SerialError("Serial group poll: Worker threads are running.");
+        
+        int timeout_ms = (timeout < 0.0) ? -1 : (int)(timeout * 1000.0);
+        size_t num = this->wait(timeout_ms);
+        
+        this->removed_members.clear();                                                      // no event refers to them any more
+        
+        return num;
+    }
+    
+    
+    void SerialGroup::run(void)
+    {
+        if(this->workers.empty() == false)
+            throw SerialError("Serial group run: Worker threads are running.");
+        
+        this->stop_flag = false;
+        
+        while(this->stop_flag == false)
+        {
+            this->wait(-1);
+            this->removed_members.clear();
+        }
+        
+        uint64_t wake_value;
+        if(::read(this->wake_fd, &wake_value, sizeof(wake_value)) < 0) {}                  // reset the wake-up event
+    }
+    
+    
+    void SerialGroup::start(unsigned threads)
+    {
+        if(this->workers.empty() == false)
+            throw SerialError("Serial group start: Worker threads are already running.");
+        if(threads == 0)
+            throw SerialError("Serial group start: At least one worker thread is necessary.");
+        
+        this->stop_flag = false;
+        this->oneshot_flag = true;                                                          // each event is handled by exactly one worker
+        this->removed_members.clear();
+        
+        for(size_t i = 0; i < this->members.size(); i++)
+            this->update(this->members[i].get(), EPOLL_CTL_MOD);
+        
+        for(unsigned i = 0; i < threads; i++)
+            this->workers.push_back(std::thread(&SerialGroup::worker_loop, this));
+    }
+    
+    
+    void SerialGroup::stop(void)
+    {
+        this->stop_flag = true;
+        
+        uint64_t wake_value = 1;
+        if(::write(this->wake_fd, &wake_value, sizeof(wake_value)) < 0)
+            throw SerialError("Serial group stop: Unable to stop event loop.");
+        
+        if(this->workers.empty() == true)
+            return;                                                                         // run returns by itself
+        
+        for(size_t i = 0; i < this->workers.size(); i++)
+            this->workers[i].join();
+        
+        this->workers.clear();
+        
+        if(::read(this->wake_fd, &wake_value, sizeof(wake_value)) < 0) {}                  // reset the wake-up event
+        
+        this->oneshot_flag = false;
+        
+        for(size_t i = 0; i < this->members.size(); i++)
+            this->update(this->members[i].get(), EPOLL_CTL_MOD);
+    }
+    
+    
+    SerialGroup::Member* SerialGroup::find(Serial& serial)
+    {
+        for(size_t i = 0; i < this->members.size(); i++)
+        {
+            if(this->members[i]->serial == &serial)
+                return this->members[i].get();
+        }
+        
+        return NULL;
+    }
+    
+    
+    void SerialGroup::update(Member* member, int operation)
+    {
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = member;
+        
+        if(member->writable_flag == true)
+            event.events |= EPOLLOUT;
+        if(this->oneshot_flag == true)
+            event.events |= EPOLLONESHOT;
+        
+        if(epoll_ctl(this->epoll_fd, operation, member->fd, &event) != 0)
+            throw SerialError("Serial group: Unable to register serial port.");
+    }
+    
+    
+    void SerialGroup::dispatch(Member* member, uint32_t events)
+    {
+        try
+        {
+            if(events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+            {
+                member->serial->receive();                                                  // drain the kernel buffer into the receive buffer
+                
+                if(member->readable_handler)
+                    member->readable_handler(*member->serial);
+            }
+            
+            if((events & EPOLLOUT) && member->writable_handler)
+                member->writable_handler(*member->serial);
+            
+            if(this->oneshot_flag == true && member->removed_flag == false)
+                this->update(member, EPOLL_CTL_MOD);                                        // rearm for the next event
+        }
+        catch(const std::exception& e)
+        {
+            epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, member->fd, NULL);                     // a failed port would report events forever
+            
+            if(this->error_handler_stored)
+                this->error_handler_stored(*member->serial, e);
+        }
+    }
+    
+    
+    size_t SerialGroup::wait(int timeout_ms)
+    {
+        struct epoll_event events[SERIAL_GROUP_MAX_EVENTS];
+        int max_events = (this->oneshot_flag == true) ? SERIAL_GROUP_WORKER_EVENTS : SERIAL_GROUP_MAX_EVENTS;
+        int num = epoll_wait(this->epoll_fd, events, max_events, timeout_ms);
+        
+        if(num < 0)
+        {
+            if(errno == EINTR)
+                return 0;
+            throw SerialError("Serial group: Epoll wait failed.");
+        }
+        
+        size_t handled = 0;
+        
+        for(int i = 0; i < num; i++)
+        {
+            Member* member = (Member*)events[i].data.ptr;
+            
+            if(member == NULL || member->removed_flag == true)
+                continue;                                                                   // wake-up event or removed by a previous handler
+            
+            this->dispatch(member, events[i].events);
+            handled++;
+        }
+        
+        return handled;
+    }
+    
+    
+    void SerialGroup::worker_loop(void)
+    {
+        while(this->stop_flag == false)
+            this->wait(-1);
+    }
+}
+
+
+
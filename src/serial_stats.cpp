@@ -0,0 +1,273 @@
+/**
+ * @file serial_stats.cpp
+ * @brief Serial statistics source file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ */
+
+
+#include <iostream>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "serial_stats.hpp"
+
+
+namespace serial
+{
+    Histogram::Histogram(void)
+    {
+        this->counts.fill(0);
+        this->total = 0;
+        this->sum = 0;
+        this->max = 0;
+    }
+    
+    
+    uint64_t Histogram::count(void) const
+    {
+        return this->total;
+    }
+    
+    
+    double Histogram::mean(void) const
+    {
+        if(this->total == 0)
+            return 0.0;
+        
+        return (double)this->sum / this->total;
+    }
+    
+    
+    uint64_t Histogram::percentile(double p) const
+    {
+        if(this->total == 0)
+            return 0;
+        
+        uint64_t rank = (uint64_t)(p * this->total);
+        uint64_t seen = 0;
+        
+        if(rank >= this->total)
+            rank = this->total - 1;
+        
+        for(size_t i = 0; i < this->counts.size(); i++)
+        {
+            seen += this->counts[i];
+            
+            if(seen > rank)
+                return (bucket_limit(i) < this->max) ? bucket_limit(i) : this->max;
+        }
+        
+        return this->max;
+    }
+    
+    
+    size_t Histogram::bucket(uint64_t value)
+    {
+        if(value < SERIAL_HISTOGRAM_SUB_BUCKETS)
+            return value;                                                                   // small values are stored exactly
+        
+        int exponent = 63 - __builtin_clzll(value);
+        
+        if(exponent >= SERIAL_HISTOGRAM_MAX_EXPONENT)
+            return SERIAL_HISTOGRAM_BUCKETS - 1;
+        
+        int shift = exponent - 4;                                                           // keep the 4 bits below the leading one
+        
+        return SERIAL_HISTOGRAM_SUB_BUCKETS * (shift + 1) + ((value >> shift) - SERIAL_HISTOGRAM_SUB_BUCKETS);
+    }
+    
+    
+    uint64_t Histogram::bucket_limit(size_t index)
+    {
+        if(index < SERIAL_HISTOGRAM_SUB_BUCKETS)
+            return index;
+        
+        int shift = index / SERIAL_HISTOGRAM_SUB_BUCKETS - 1;
+        uint64_t lower = (uint64_t)(SERIAL_HISTOGRAM_SUB_BUCKETS + index % SERIAL_HISTOGRAM_SUB_BUCKETS) << shift;
+        
+        return lower + ((uint64_t)1 << shift) - 1;
+    }
+    
+    
+    StatsRecorder::StatsRecorder(void)
+    {
+        this->reset();
+    }
+    
+    
+    void StatsRecorder::rx_syscall(void)
+    {
+        this->rx_syscalls.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    
+    void StatsRecorder::tx_syscall(void)
+    {
+        this->tx_syscalls.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    
+    void StatsRecorder::received(size_t bytes)
+    {
+        this->rx_syscalls.fetch_add(1, std::memory_order_relaxed);
+        this->rx_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    
+    
+    void StatsRecorder::sent(size_t bytes, bool partial)
+    {
+        this->tx_syscalls.fetch_add(1, std::memory_order_relaxed);
+        this->tx_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        
+        if(partial == true)
+            this->partial_writes.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    
+    void StatsRecorder::rx_wait(uint64_t ns, bool timeout)
+    {
+        record(this->read_wait, ns);
+        
+        if(timeout == true)
+            this->rx_timeouts.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    
+    void StatsRecorder::tx_timeout(void)
+    {
+        this->tx_timeouts.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    
+    void StatsRecorder::write_completed(uint64_t ns)
+    {
+        record(this->write_time, ns);
+    }
+    
+    
+    void StatsRecorder::spin(uint64_t ns, bool hit)
+    {
+        if(hit == true)
+        {
+            this->spin_hits.fetch_add(1, std::memory_order_relaxed);
+            record(this->spin_wait, ns);
+        }
+        else
+            this->spin_misses.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    
+    void StatsRecorder::snapshot(SerialStats& stats) const
+    {
+        stats.rx_bytes = this->rx_bytes.load(std::memory_order_relaxed);
+        stats.tx_bytes = this->tx_bytes.load(std::memory_order_relaxed);
+        stats.rx_syscalls = this->rx_syscalls.load(std::memory_order_relaxed);
+        stats.tx_syscalls = this->tx_syscalls.load(std::memory_order_relaxed);
+        stats.rx_timeouts = this->rx_timeouts.load(std::memory_order_relaxed);
+        stats.tx_timeouts = this->tx_timeouts.load(std::memory_order_relaxed);
+        stats.partial_writes = this->partial_writes.load(std::memory_order_relaxed);
+        copy(this->read_wait, stats.read_wait);
+        copy(this->write_time, stats.write_time);
+        stats.spin_hits = this->spin_hits.load(std::memory_order_relaxed);
+        stats.spin_misses = this->spin_misses.load(std::memory_order_relaxed);
+        copy(this->spin_wait, stats.spin_wait);
+    }
+    
+    
+    void StatsRecorder::reset(void)
+    {
+        this->rx_bytes = 0;
+        this->tx_bytes = 0;
+        this->rx_syscalls = 0;
+        this->tx_syscalls = 0;
+        this->rx_timeouts = 0;
+        this->tx_timeouts = 0;
+        this->partial_writes = 0;
+        clear(this->read_wait);
+        clear(this->write_time);
+        this->spin_hits = 0;
+        this->spin_misses = 0;
+        clear(this->spin_wait);
+    }
+    
+    
+    void StatsRecorder::record(AtomicHistogram& histogram, uint64_t value)
+    {
+        histogram.counts[Histogram::bucket(value)].fetch_add(1, std::memory_order_relaxed);
+        histogram.sum.fetch_add(value, std::memory_order_relaxed);
+        
+        uint64_t max = histogram.max.load(std::memory_order_relaxed);
+        
+        while(value > max && histogram.max.compare_exchange_weak(max, value, std::memory_order_relaxed) == false);
+    }
+    
+    
+    void StatsRecorder::copy(const AtomicHistogram& histogram, Histogram& output)
+    {
+        output.total = 0;
+        
+        for(size_t i = 0; i < output.counts.size(); i++)
+        {
+            output.counts[i] = histogram.counts[i].load(std::memory_order_relaxed);
+            output.total += output.counts[i];                                               // consistent with the buckets during recording
+        }
+        
+        output.sum = histogram.sum.load(std::memory_order_relaxed);
+        output.max = histogram.max.load(std::memory_order_relaxed);
+    }
+    
+    
+    void StatsRecorder::clear(AtomicHistogram& histogram)
+    {
+        for(std::atomic<uint64_t>& count : histogram.counts)
+            count.store(0, std::memory_order_relaxed);
+        
+        histogram.sum = 0;
+        histogram.max = 0;
+    }
+    
+    
+    static void print_histogram(std::ostream &out, const char* name, Histogram const& histogram)
+    {
+        out << name << ": " << histogram.count() << " samples";
+        
+        if(histogram.count() > 0)
+        {
+            out << ", p50 " << histogram.percentile(0.5) / 1000.0 << " us, p99 " << histogram.percentile(0.99) / 1000.0
+                << " us, max " << histogram.max / 1000.0 << " us";
+        }
+        
+        out << std::endl;
+    }
+    
+    
+    std::ostream& operator<< (std::ostream &out, SerialStats const& stats)
+    {
+        out << "RX: " << stats.rx_bytes << " Bytes, " << stats.rx_syscalls << " syscalls, " << stats.rx_timeouts << " timeouts" << std::endl;
+        out << "TX: " << stats.tx_bytes << " Bytes, " << stats.tx_syscalls << " syscalls, " << stats.tx_timeouts << " timeouts, "
+            << stats.partial_writes << " partial writes" << std::endl;
+        print_histogram(out, "Read wait", stats.read_wait);
+        print_histogram(out, "Write time", stats.write_time);
+        
+        if(stats.spin_hits + stats.spin_misses > 0)
+        {
+            out << "Busy poll: " << stats.spin_hits << " hits, " << stats.spin_misses << " misses" << std::endl;
+            print_histogram(out, "Spin wait", stats.spin_wait);
+        }
+        
+        if(stats.icount_valid == true)
+        {
+            out << "Errors: " << stats.frame_errors << " frame, " << stats.parity_errors << " parity, " << stats.overruns << " overrun, "
+                << stats.buffer_overruns << " buffer overrun, " << stats.breaks << " break";
+        }
+        else
+            out << "Errors: not available";
+        
+        return out;
+    }
+}
+
+
+
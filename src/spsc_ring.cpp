@@ -0,0 +1,218 @@
+/**
+ * @file spsc_ring.cpp
+ * @brief Single-producer/single-consumer ring source file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ */
+
+
+#include <vector>
+#include <span>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include "spsc_ring.hpp"
+
+
+namespace serial
+{
+    static size_t round_up_power_of_two(size_t value)
+    {
+        size_t result = 1;
+        
+        while(result < value)
+            result <<= 1;
+        
+        return result;
+    }
+    
+    
+    SpscRing::SpscRing(size_t capacity) : storage(round_up_power_of_two(capacity))
+    {
+        this->mask = this->storage.size() - 1;
+        this->head = 0;
+        this->tail = 0;
+        this->data_event = 0;
+        this->space_event = 0;
+        this->consumer_waiting = false;
+        this->producer_waiting = false;
+        this->closed_flag = false;
+    }
+    
+    
+    std::span<uint8_t> SpscRing::write_span(void)
+    {
+        size_t tail = this->tail.load(std::memory_order_relaxed);
+        size_t head = this->head.load(std::memory_order_acquire);
+        size_t free_space = this->storage.size() - (tail - head);
+        size_t offset = tail & this->mask;
+        size_t contiguous = this->storage.size() - offset;                                  // space up to the end of the storage
+        
+        return std::span<uint8_t>(this->storage.data() + offset, (free_space < contiguous) ? free_space : contiguous);
+    }
+    
+    
+    void SpscRing::produce(size_t size)
+    {
+        this->tail.store(this->tail.load(std::memory_order_relaxed) + size, std::memory_order_seq_cst);
+        
+        if(this->consumer_waiting.load(std::memory_order_seq_cst) == true)                  // only wake the consumer if it sleeps
+        {
+            this->data_event.fetch_add(1, std::memory_order_seq_cst);
+            syscall(SYS_futex, &this->data_event, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+        }
+    }
+    
+    
+    std::span<const uint8_t> SpscRing::read_span(void)
+    {
+        size_t head = this->head.load(std::memory_order_relaxed);
+        size_t tail = this->tail.load(std::memory_order_acquire);
+        size_t offset = head & this->mask;
+        size_t contiguous = this->storage.size() - offset;                                  // data up to the end of the storage
+        size_t available = tail - head;
+        
+        return std::span<const uint8_t>(this->storage.data() + offset, (available < contiguous) ? available : contiguous);
+    }
+    
+    
+    void SpscRing::consume(size_t size)
+    {
+        this->head.store(this->head.load(std::memory_order_relaxed) + size, std::memory_order_seq_cst);
+        
+        if(this->producer_waiting.load(std::memory_order_seq_cst) == true)                  // only wake the producer if it sleeps
+        {
+            this->space_event.fetch_add(1, std::memory_order_seq_cst);
+            syscall(SYS_futex, &this->space_event, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+        }
+    }
+    
+    
+    size_t SpscRing::read(uint8_t* buffer, size_t size)
+    {
+        size_t num = 0;
+        
+        while(num < size)                                                                   // at most two spans because of the wrap-around
+        {
+            std::span<const uint8_t> data = this->read_span();
+            
+            if(data.empty() == true)
+                break;
+            
+            size_t num_temp = (data.size() < size - num) ? data.size() : size - num;
+            std::memcpy(buffer + num, data.data(), num_temp);
+            this->consume(num_temp);
+            num += num_temp;
+        }
+        
+        return num;
+    }
+    
+    
+    bool SpscRing::readable(void) const
+    {
+        return this->tail.load(std::memory_order_seq_cst) != this->head.load(std::memory_order_relaxed);
+    }
+    
+    
+    bool SpscRing::writable(void) const
+    {
+        return this->tail.load(std::memory_order_relaxed) - this->head.load(std::memory_order_seq_cst) < this->storage.size();
+    }
+    
+    
+    bool SpscRing::wait(std::atomic<uint32_t>& event, std::atomic<bool>& waiting, bool (SpscRing::*ready)(void) const, const struct timespec* timeout)
+    {
+        struct timespec deadline;
+        struct timespec* deadline_ptr = NULL;
+        
+        if(timeout != NULL)                                                                 // absolute deadline, so wake-ups without data do not extend the wait
+        {
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+            deadline.tv_sec += timeout->tv_sec;
+            deadline.tv_nsec += timeout->tv_nsec;
+            
+            if(deadline.tv_nsec >= 1000000000L)
+            {
+                deadline.tv_sec += 1;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            
+            deadline_ptr = &deadline;
+        }
+        
+        while((this->*ready)() == false)
+        {
+            if(this->closed_flag.load() == true)
+                return false;
+            
+            uint32_t event_value = event.load(std::memory_order_seq_cst);
+            waiting.store(true, std::memory_order_seq_cst);
+            
+            if((this->*ready)() == true || this->closed_flag.load() == true)                // recheck after announcing the wait, the other side may have missed it
+            {
+                waiting.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            
+            long status = syscall(SYS_futex, &event, FUTEX_WAIT_BITSET_PRIVATE, event_value, deadline_ptr, NULL, FUTEX_BITSET_MATCH_ANY);
+            waiting.store(false, std::memory_order_relaxed);
+            
+            if(status != 0 && errno == ETIMEDOUT)
+                return (this->*ready)();
+        }
+        
+        return true;
+    }
+    
+    
+    bool SpscRing::wait_writable(const struct timespec* timeout)
+    {
+        return this->wait(this->space_event, this->producer_waiting, &SpscRing::writable, timeout);
+    }
+    
+    
+    bool SpscRing::wait_readable(const struct timespec* timeout)
+    {
+        return this->wait(this->data_event, this->consumer_waiting, &SpscRing::readable, timeout);
+    }
+    
+    
+    void SpscRing::close(void)
+    {
+        this->closed_flag = true;
+        this->data_event.fetch_add(1);
+        this->space_event.fetch_add(1);
+        syscall(SYS_futex, &this->data_event, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+        syscall(SYS_futex, &this->space_event, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+    
+    
+    bool SpscRing::is_closed(void) const
+    {
+        return this->closed_flag.load();
+    }
+    
+    
+    size_t SpscRing::size(void) const
+    {
+        return this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire);
+    }
+    
+    
+    size_t SpscRing::capacity(void) const
+    {
+        return this->storage.size();
+    }
+}
+
+
+
@@ -0,0 +1,533 @@
+/**
+ * @file transport.cpp
+ * @brief Transport source file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ */
+
+
+#include <string>
+#include <memory>
+#include <utility>
+#include <atomic>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/uio.h>
+#include <sys/eventfd.h>
+
+#include "transport.hpp"
+#include "serial.hpp"
+#include "baudrate.hpp"
+
+
+namespace serial
+{
+    struct MemoryLink                                                                       // one direction of a memory pair
+    {
+        SpscRing ring;
+        int event_fd;                                   // readable while the ring holds data, for poll and epoll
+        std::atomic<bool> signaled;                     // event_fd is set
+        std::atomic<int> lines;                         // RTS and DTR of the writing end
+        
+        explicit MemoryLink(size_t capacity) : ring(capacity), signaled(false), lines(0)
+        {
+            this->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        }
+        
+        ~MemoryLink()
+        {
+            if(this->event_fd >= 0)
+                ::close(this->event_fd);
+        }
+        
+        void signal(void)                                                                   // only the transition to readable takes a system call
+        {
+            if(this->signaled.exchange(true) == false)
+            {
+                uint64_t value = 1;
+                
+                if(::write(this->event_fd, &value, sizeof(value)) < 0) {}
+            }
+        }
+        
+        void clear(void)
+        {
+            if(this->signaled.exchange(false) == true)
+            {
+                uint64_t value;
+                
+                if(::read(this->event_fd, &value, sizeof(value)) < 0) {}
+                
+                if(this->ring.size() > 0)                                                   // data produced meanwhile, its signal may have been reset
+                    this->signal();
+            }
+        }
+    };
+    
+    
+    Transport::Transport() : fd(-1), lines_stored(0)
+    {
+    }
+    
+    
+    Transport::~Transport()
+    {
+    }
+    
+    
+    int Transport::fileno(void)
+    {
+        return this->fd;
+    }
+    
+    
+    ssize_t Transport::read(uint8_t* buffer, size_t size)
+    {
+        return ::read(this->fd, buffer, size);
+    }
+    
+    
+    ssize_t Transport::writev(const struct iovec* iov, int count)
+    {
+        return ::writev(this->fd, iov, count);
+    }
+    
+    
+    int Transport::wait(short events, const struct timespec* timeout)
+    {
+        struct pollfd poll_fd;
+        poll_fd.fd = this->fd;                                                              // poll instead of select, works for file descriptors above FD_SETSIZE
+        poll_fd.events = events;
+        
+        return ppoll(&poll_fd, 1, timeout, NULL);
+    }
+    
+    
+    bool Transport::flush(bool input, bool output)
+    {
+        uint8_t buffer[1024];
+        
+        while(input == true && this->read(buffer, sizeof(buffer)) > 0) {}
+        
+        return true;
+    }
+    
+    
+    bool Transport::baudrate(uint32_t baudrate)
+    {
+        return true;
+    }
+    
+    
+    bool Transport::set_lines(int lines, bool state)
+    {
+        if(state == true)
+            this->lines_stored |= lines;
+        else
+            this->lines_stored &= ~lines;
+        
+        return true;
+    }
+    
+    
+    bool Transport::get_lines(int& lines)
+    {
+        lines = this->lines_stored;
+        return true;
+    }
+    
+    
+    bool Transport::direct_io(void)
+    {
+        return true;
+    }
+    
+    
+    bool Transport::output_events(void)
+    {
+        return true;
+    }
+    
+    
+    int TtyTransport::open(const std::string& port, uint32_t baudrate)
+    {
+        this->fd = ::open(port.c_str(), O_RDWR | O_NOCTTY | O_NDELAY);
+        
+        if(this->fd < 0)
+            throw SerialError("Serial open: Unable to open serialport.");
+        
+        if(flock(this->fd, LOCK_EX | LOCK_NB) < 0)
+        {
+            ::close(this->fd);
+            this->fd = -1;
+            throw SerialError("Serial open: Serial port is already locked by another process.");
+        }
+        
+        try
+        {
+            struct termios port_settings;
+            
+            if(tcgetattr(this->fd, &port_settings) != 0)                                    // read existing settings
+                throw SerialError("Serial open: Failed to read existing port settings.");
+            
+            speed_t speed_existing = cfgetospeed(&port_settings);                           // keep the speed until the baudrate is set, B0 would hang up
+            
+            port_settings.c_cflag = CS8 | CLOCAL | CREAD;
+            port_settings.c_iflag = 0;
+            port_settings.c_oflag = 0;
+            port_settings.c_lflag = 0;
+            port_settings.c_cc[VMIN] = 0;
+            port_settings.c_cc[VTIME] = 0;
+            cfsetispeed(&port_settings, speed_existing);
+            cfsetospeed(&port_settings, speed_existing);
+            
+            
+            if(tcsetattr(this->fd, TCSANOW, &port_settings) != 0)                           // save serial settings
+                throw SerialError("Serial open: Failed to set port settings.");
+            
+            if(set_baudrate(this->fd, baudrate) == false)                                   // any baudrate supported by the driver
+                throw SerialError("Serial open: Baudrate is not supported.");
+        }
+        catch(...)
+        {
+            this->close();
+            throw;
+        }
+        
+        return this->fd;
+    }
+    
+    
+    bool TtyTransport::close(void)
+    {
+        if(this->fd < 0)
+            return false;
+        
+        bool success = (flock(this->fd, LOCK_UN) == 0);
+        success = (::close(this->fd) == 0) && success;
+        this->fd = -1;
+        
+        return success;
+    }
+    
+    
+    bool TtyTransport::flush(bool input, bool output)
+    {
+        int queue = (input == true && output == true) ? TCIOFLUSH : ((input == true) ? TCIFLUSH : TCOFLUSH);
+        
+        return tcflush(this->fd, queue) == 0;
+    }
+    
+    
+    bool TtyTransport::baudrate(uint32_t baudrate)
+    {
+        return set_baudrate(this->fd, baudrate);
+    }
+    
+    
+    bool TtyTransport::set_lines(int lines, bool state)
+    {
+        return ioctl(this->fd, (state == true) ? TIOCMBIS : TIOCMBIC, &lines) == 0;
+    }
+    
+    
+    bool TtyTransport::get_lines(int& lines)
+    {
+        return ioctl(this->fd, TIOCMGET, &lines) == 0;
+    }
+    
+    
+    PtyTransport::PtyTransport() : peer_fd_stored(-1)
+    {
+    }
+    
+    
+    PtyTransport::~PtyTransport()
+    {
+        this->close();
+    }
+    
+    
+    int PtyTransport::open(const std::string& port, uint32_t baudrate)
+    {
+        this->peer_fd_stored = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+        
+        char name[64];
+        
+        if(this->peer_fd_stored < 0 || grantpt(this->peer_fd_stored) != 0 || unlockpt(this->peer_fd_stored) != 0 || ptsname_r(this->peer_fd_stored, name, sizeof(name)) != 0)
+        {
+            this->close();
+            throw SerialError("Serial open: Unable to create pty.");
+        }
+        
+        this->name_stored = name;
+        
+        try
+        {
+            return TtyTransport::open(this->name_stored, baudrate);
+        }
+        catch(...)
+        {
+            this->close();
+            throw;
+        }
+    }
+    
+    
+    bool PtyTransport::close(void)
+    {
+        bool success = true;
+        
+        if(this->fd >= 0)
+            success = TtyTransport::close();
+        
+        if(this->peer_fd_stored >= 0)
+            ::close(this->peer_fd_stored);
+        
+        this->peer_fd_stored = -1;
+        this->name_stored.clear();
+        
+        return success;
+    }
+    
+    
+    bool PtyTransport::set_lines(int lines, bool state)
+    {
+        return Transport::set_lines(lines, state);                                          // ptys have no control lines
+    }
+    
+    
+    bool PtyTransport::get_lines(int& lines)
+    {
+        return Transport::get_lines(lines);
+    }
+    
+    
+    int PtyTransport::peer_fd(void)
+    {
+        return this->peer_fd_stored;
+    }
+    
+    
+    std::string PtyTransport::name(void)
+    {
+        return this->name_stored;
+    }
+    
+    
+    int UnixSocketTransport::open(const std::string& port, uint32_t baudrate)
+    {
+        struct sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        
+        if(port.size() >= sizeof(address.sun_path))
+            throw SerialError("Serial open: Socket path is too long.");
+        
+        memcpy(address.sun_path, port.c_str(), port.size() + 1);
+        this->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        
+        if(this->fd < 0)
+            throw SerialError("Serial open: Unable to create socket.");
+        
+        if(connect(this->fd, (struct sockaddr*)&address, sizeof(address)) != 0 || fcntl(this->fd, F_SETFL, fcntl(this->fd, F_GETFL) | O_NONBLOCK) != 0)
+        {
+            this->close();
+            throw SerialError("Serial open: Unable to connect to socket.");
+        }
+        
+        return this->fd;
+    }
+    
+    
+    bool UnixSocketTransport::close(void)
+    {
+        if(this->fd < 0)
+            return false;
+        
+        bool success = (::close(this->fd) == 0);
+        this->fd = -1;
+        
+        return success;
+    }
+    
+    
+    ssize_t UnixSocketTransport::read(uint8_t* buffer, size_t size)
+    {
+        ssize_t num = ::read(this->fd, buffer, size);
+        
+        if(num == 0 && size > 0)                                                            // end of stream, unlike 0 Bytes of a tty with VMIN 0
+        {
+            errno = ECONNRESET;
+            return -1;
+        }
+        
+        return num;
+    }
+    
+    
+    MemoryTransport::MemoryTransport(std::shared_ptr<MemoryLink> rx_link, std::shared_ptr<MemoryLink> tx_link) : rx_link(rx_link), tx_link(tx_link)
+    {
+    }
+    
+    
+    std::pair<std::shared_ptr<MemoryTransport>, std::shared_ptr<MemoryTransport>> MemoryTransport::pair(void)
+    {
+        return pair(TRANSPORT_MEMORY_CAPACITY);
+    }
+    
+    
+    std::pair<std::shared_ptr<MemoryTransport>, std::shared_ptr<MemoryTransport>> MemoryTransport::pair(size_t capacity)
+    {
+        std::shared_ptr<MemoryLink> first_link = std::make_shared<MemoryLink>(capacity);
+        std::shared_ptr<MemoryLink> second_link = std::make_shared<MemoryLink>(capacity);
+        
+        if(first_link->event_fd < 0 || second_link->event_fd < 0)
+            throw SerialError("Memory transport: Unable to create event.");
+        
+        std::shared_ptr<MemoryTransport> first(new MemoryTransport(first_link, second_link));
+        std::shared_ptr<MemoryTransport> second(new MemoryTransport(second_link, first_link));
+        
+        return std::make_pair(first, second);
+    }
+    
+    
+    int MemoryTransport::open(const std::string& port, uint32_t baudrate)
+    {
+        this->fd = this->rx_link->event_fd;
+        return this->fd;
+    }
+    
+    
+    bool MemoryTransport::close(void)
+    {
+        if(this->fd < 0)
+            return false;
+        
+        this->fd = -1;                                                                      // the event belongs to the link and stays open for the other end
+        return true;
+    }
+    
+    
+    ssize_t MemoryTransport::read(uint8_t* buffer, size_t size)
+    {
+        size_t num = this->rx_link->ring.read(buffer, size);
+        
+        if(this->rx_link->ring.size() == 0)
+            this->rx_link->clear();
+        
+        if(num == 0 && size > 0)
+        {
+            errno = EAGAIN;
+            return -1;
+        }
+        
+        return num;
+    }
+    
+    
+    ssize_t MemoryTransport::writev(const struct iovec* iov, int count)
+    {
+        SpscRing& ring = this->tx_link->ring;
+        size_t num = 0;
+        size_t total = 0;
+        
+        for(int i = 0; i < count; i++)
+        {
+            const uint8_t* data = (const uint8_t*)iov[i].iov_base;
+            size_t offset = 0;
+            total += iov[i].iov_len;
+            
+            while(offset < iov[i].iov_len)                                                  // at most two spans because of the wrap-around
+            {
+                std::span<uint8_t> space = ring.write_span();
+                
+                if(space.empty() == true)
+                    break;
+                
+                size_t num_temp = (space.size() < iov[i].iov_len - offset) ? space.size() : iov[i].iov_len - offset;
+                memcpy(space.data(), data + offset, num_temp);
+                ring.produce(num_temp);
+                offset += num_temp;
+                num += num_temp;
+            }
+            
+            if(offset < iov[i].iov_len)
+                break;
+        }
+        
+        if(num > 0)
+            this->tx_link->signal();
+        
+        if(num == 0 && total > 0)                                                           // ring is full
+        {
+            errno = EAGAIN;
+            return -1;
+        }
+        
+        return num;
+    }
+    
+    
+    int MemoryTransport::wait(short events, const struct timespec* timeout)
+    {
+        if(events & POLLOUT)                                                                // the ring wakes a waiting writer directly
+            return (this->tx_link->ring.wait_writable(timeout) == true) ? 1 : 0;
+        
+        return Transport::wait(events, timeout);
+    }
+    
+    
+    bool MemoryTransport::set_lines(int lines, bool state)
+    {
+        if(state == true)
+            this->tx_link->lines.fetch_or(lines & (TIOCM_RTS | TIOCM_DTR));
+        else
+            this->tx_link->lines.fetch_and(~(lines & (TIOCM_RTS | TIOCM_DTR)));
+        
+        return true;
+    }
+    
+    
+    bool MemoryTransport::get_lines(int& lines)
+    {
+        int peer_lines = this->rx_link->lines.load();
+        lines = this->tx_link->lines.load();
+        
+        if(peer_lines & TIOCM_RTS)
+            lines |= TIOCM_CTS;
+        if(peer_lines & TIOCM_DTR)
+            lines |= TIOCM_DSR | TIOCM_CD;
+        
+        return true;
+    }
+    
+    
+    bool MemoryTransport::direct_io(void)
+    {
+        return false;
+    }
+    
+    
+    bool MemoryTransport::output_events(void)
+    {
+        return false;
+    }
+}
+
+
+
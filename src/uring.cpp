@@ -0,0 +1,198 @@
+/**
+ * @file uring.cpp
+ * @brief io_uring source file
+ * @author Markus Hehn
+ * @date 17.10.2026
+ */
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#include "uring.hpp"
+
+
+namespace serial
+{
+    IoUring::IoUring()
+    {
+        this->ring_fd = -1;
+        this->sq_map = MAP_FAILED;
+        this->cq_map = MAP_FAILED;
+        this->sqes = (struct io_uring_sqe*)MAP_FAILED;
+        this->sq_map_size = 0;
+        this->cq_map_size = 0;
+        this->sqes_size = 0;
+        this->sq_entries = 0;
+        this->prepared_tail = 0;
+    }
+    
+    
+    IoUring::~IoUring()
+    {
+        if(this->sqes != MAP_FAILED)
+            munmap(this->sqes, this->sqes_size);
+        if(this->cq_map != MAP_FAILED && this->cq_map != this->sq_map)
+            munmap(this->cq_map, this->cq_map_size);
+        if(this->sq_map != MAP_FAILED)
+            munmap(this->sq_map, this->sq_map_size);
+        if(this->ring_fd >= 0)
+            ::close(this->ring_fd);
+    }
+    
+    
+    bool IoUring::setup(unsigned entries)
+    {
+        struct io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        
+        this->ring_fd = syscall(__NR_io_uring_setup, entries, &params);
+        
+        if(this->ring_fd < 0)
+            return false;
+        if((params.features & IORING_FEAT_EXT_ARG) == 0)                                    // timeouts of io_uring_enter, Linux 5.11
+            return false;
+        
+        this->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        this->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        
+        if(params.features & IORING_FEAT_SINGLE_MMAP)                                       // both rings in one mapping
+        {
+            if(this->cq_map_size > this->sq_map_size)
+                this->sq_map_size = this->cq_map_size;
+            this->cq_map_size = this->sq_map_size;
+        }
+        
+        this->sq_map = mmap(NULL, this->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->ring_fd, IORING_OFF_SQ_RING);
+        
+        if(this->sq_map == MAP_FAILED)
+            return false;
+        
+        if(params.features & IORING_FEAT_SINGLE_MMAP)
+            this->cq_map = this->sq_map;
+        else
+            this->cq_map = mmap(NULL, this->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->ring_fd, IORING_OFF_CQ_RING);
+        
+        if(this->cq_map == MAP_FAILED)
+            return false;
+        
+        this->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+        this->sqes = (struct io_uring_sqe*)mmap(NULL, this->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->ring_fd, IORING_OFF_SQES);
+        
+        if(this->sqes == MAP_FAILED)
+            return false;
+        
+        uint8_t* sq = (uint8_t*)this->sq_map;
+        uint8_t* cq = (uint8_t*)this->cq_map;
+        
+        this->sq_head = (unsigned*)(sq + params.sq_off.head);
+        this->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+        this->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+        this->sq_array = (unsigned*)(sq + params.sq_off.array);
+        this->cq_head = (unsigned*)(cq + params.cq_off.head);
+        this->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+        this->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+        this->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+        this->sq_entries = params.sq_entries;
+        this->prepared_tail = *this->sq_tail;
+        
+        return true;
+    }
+    
+    
+    bool IoUring::register_file(int fd)
+    {
+        return syscall(__NR_io_uring_register, this->ring_fd, IORING_REGISTER_FILES, &fd, 1) == 0;
+    }
+    
+    
+    struct io_uring_sqe* IoUring::sqe(void)
+    {
+        unsigned head = std::atomic_ref<unsigned>(*this->sq_head).load(std::memory_order_acquire);
+        unsigned tail = this->prepared_tail;
+        
+        if(tail - head >= this->sq_entries)
+            return NULL;                                                                    // submission queue is full
+        
+        unsigned index = tail & *this->sq_mask;
+        struct io_uring_sqe* entry = &this->sqes[index];
+        
+        std::memset(entry, 0, sizeof(*entry));
+        this->sq_array[index] = index;
+        this->prepared_tail++;
+        
+        return entry;
+    }
+    
+    
+    int IoUring::submit(unsigned wait_count, const struct timespec* timeout)
+    {
+        std::atomic_ref<unsigned>(*this->sq_tail).store(this->prepared_tail, std::memory_order_release);
+        unsigned to_submit = this->prepared_tail - std::atomic_ref<unsigned>(*this->sq_head).load(std::memory_order_acquire);
+        
+        struct __kernel_timespec timeout_struct;
+        struct io_uring_getevents_arg arg;
+        std::memset(&arg, 0, sizeof(arg));
+        
+        if(timeout != NULL)
+        {
+            timeout_struct.tv_sec = timeout->tv_sec;
+            timeout_struct.tv_nsec = timeout->tv_nsec;
+            arg.ts = (uint64_t)&timeout_struct;
+        }
+        
+        unsigned flags = IORING_ENTER_EXT_ARG | ((wait_count > 0) ? IORING_ENTER_GETEVENTS : 0);
+        
+        if(syscall(__NR_io_uring_enter, this->ring_fd, to_submit, wait_count, flags, &arg, sizeof(arg)) < 0)
+            return -errno;
+        
+        return 0;                                                                           // the wait may end early, e.g. by a signal, check the completions
+    }
+    
+    
+    unsigned IoUring::discard(void)
+    {
+        unsigned head = std::atomic_ref<unsigned>(*this->sq_head).load(std::memory_order_acquire);
+        unsigned dropped = this->prepared_tail - head;
+        
+        this->prepared_tail = head;
+        std::atomic_ref<unsigned>(*this->sq_tail).store(head, std::memory_order_release);  // the kernel reads the tail only in io_uring_enter
+        
+        return dropped;
+    }
+    
+    
+    bool IoUring::completion(struct io_uring_cqe& cqe)
+    {
+        unsigned head = *this->cq_head;
+        unsigned tail = std::atomic_ref<unsigned>(*this->cq_tail).load(std::memory_order_acquire);
+        
+        if(head == tail)
+            return false;
+        
+        cqe = this->cqes[head & *this->cq_mask];
+        std::atomic_ref<unsigned>(*this->cq_head).store(head + 1, std::memory_order_release);
+        
+        return true;
+    }
+    
+    
+    bool IoUring::supported(void)
+    {
+        IoUring ring;
+        
+        return ring.setup(2);
+    }
+}
+
+
+